@@ -1,9 +1,18 @@
 #include <iostream>
 #include <string>
 #include <limits>
+#include <vector>
+#include <memory>
+#include <new>
+#include <utility>
+#include <random>
+#include <chrono>
+#include <iomanip>
+#include <algorithm>
 
 using namespace std;
 
+// One node per task, the original design; kept for the traversal benchmark
 struct Task {
     string description;
     Task* prev;
@@ -11,116 +20,422 @@ struct Task {
     Task(string desc) : description(desc), prev(nullptr), next(nullptr) {}
 };
 
-// Doubly Linked List for to-do list
-class TaskManager {
+// Pool of same-sized objects. Memory comes in slabs of SLAB_SIZE objects and
+// released objects go on a free list, so allocating is a pointer pop and
+// neighbouring nodes share cache lines and pages instead of being scattered
+// over the heap.
+template <typename Object>
+class SlabPool {
 private:
-    Task* current;
-    Task* head;
+    static const size_t SLAB_SIZE = 64;
+
+    union Slot {
+        Slot* nextFree;
+        alignas(Object) unsigned char storage[sizeof(Object)];
+    };
+
+    vector<unique_ptr<Slot[]>> slabs;
+    Slot* freeList;
 
 public:
-    TaskManager() : current(nullptr), head(nullptr) {}
+    SlabPool() : freeList(nullptr) {}
 
-    // Add a new task
-    void addTask(string description) {
-        Task* newTask = new Task(description);
-        if (!head) {
-            head = current = newTask;
+    SlabPool(const SlabPool&) = delete;
+    SlabPool& operator=(const SlabPool&) = delete;
+
+    Object* allocate() {
+        if (!freeList) {
+            slabs.emplace_back(new Slot[SLAB_SIZE]);
+            Slot* slab = slabs.back().get();
+            for (size_t i = 0; i < SLAB_SIZE; i++) {
+                slab[i].nextFree = i + 1 < SLAB_SIZE ? &slab[i + 1] : nullptr;
+            }
+            freeList = slab;
+        }
+        Slot* slot = freeList;
+        freeList = slot->nextFree;
+        return new (slot->storage) Object();
+    }
+
+    void release(Object* object) {
+        object->~Object();
+        Slot* slot = reinterpret_cast<Slot*>(object);
+        slot->nextFree = freeList;
+        freeList = slot;
+    }
+
+    size_t bytesReserved() const { return slabs.size() * SLAB_SIZE * sizeof(Slot); }
+};
+
+// Unrolled doubly linked list: each block holds up to CAPACITY elements in
+// an array, and blocks come from a slab pool. A traversal reads CAPACITY
+// neighbouring elements per block instead of chasing one pointer each.
+// A Position names an element by block and index. Inserting may move
+// elements between blocks, so it invalidates other positions; erase keeps
+// one tracked position (such as a cursor) pointing at the same element.
+template <typename T, size_t CAPACITY = 16>
+class UnrolledList {
+private:
+    struct Block {
+        T items[CAPACITY];
+        size_t count;
+        Block* prev;
+        Block* next;
+        Block() : count(0), prev(nullptr), next(nullptr) {}
+    };
+
+public:
+    struct Position {
+        Block* block;
+        size_t index;
+        Position(Block* b = nullptr, size_t i = 0) : block(b), index(i) {}
+        bool valid() const { return block != nullptr; }
+        bool operator==(const Position& other) const { return block == other.block && index == other.index; }
+        bool operator!=(const Position& other) const { return !(*this == other); }
+    };
+
+private:
+    Block* first;
+    Block* last;
+    size_t total;
+    size_t blocks;
+    SlabPool<Block> pool;
+
+    // New empty block linked in after b (at the front if b is null)
+    Block* addBlockAfter(Block* b) {
+        Block* block = pool.allocate();
+        block->prev = b;
+        block->next = b ? b->next : first;
+        if (block->next) {
+            block->next->prev = block;
+        } else {
+            last = block;
+        }
+        if (b) {
+            b->next = block;
+        } else {
+            first = block;
+        }
+        blocks++;
+        return block;
+    }
+
+    void removeBlock(Block* b) {
+        if (b->prev) {
+            b->prev->next = b->next;
         } else {
-            newTask->prev = current;
-            newTask->next = current->next;
-            if (current->next) {
-                current->next->prev = newTask;
+            first = b->next;
+        }
+        if (b->next) {
+            b->next->prev = b->prev;
+        } else {
+            last = b->prev;
+        }
+        pool.release(b);
+        blocks--;
+    }
+
+    // Move every element of b (the block after a) to the end of a
+    void mergeInto(Block* a, Block* b, Position& tracked) {
+        if (tracked.block == b) {
+            tracked = Position(a, a->count + tracked.index);
+        }
+        for (size_t i = 0; i < b->count; i++) {
+            a->items[a->count++] = std::move(b->items[i]);
+        }
+        removeBlock(b);
+    }
+
+public:
+    UnrolledList() : first(nullptr), last(nullptr), total(0), blocks(0) {}
+
+    ~UnrolledList() {
+        while (first) {
+            removeBlock(first);
+        }
+    }
+
+    UnrolledList(const UnrolledList&) = delete;
+    UnrolledList& operator=(const UnrolledList&) = delete;
+
+    size_t size() const { return total; }
+    bool empty() const { return total == 0; }
+    size_t blockCount() const { return blocks; }
+    size_t bytesReserved() const { return pool.bytesReserved(); }
+
+    Position begin() const { return Position(first, 0); }
+    Position back() const { return last ? Position(last, last->count - 1) : Position(); }
+
+    T& operator[](const Position& position) { return position.block->items[position.index]; }
+    const T& operator[](const Position& position) const { return position.block->items[position.index]; }
+
+    Position next(const Position& position) const {
+        if (position.index + 1 < position.block->count) {
+            return Position(position.block, position.index + 1);
+        }
+        return Position(position.block->next, 0);
+    }
+
+    Position prev(const Position& position) const {
+        if (position.index > 0) {
+            return Position(position.block, position.index - 1);
+        }
+        Block* before = position.block->prev;
+        return before ? Position(before, before->count - 1) : Position();
+    }
+
+    // Insert after position (at the front if it is not valid). Going past
+    // the end of a full block uses the next block or a new one, so appending
+    // fills blocks completely; any other insert into a full block splits it
+    // in half first. Returns the new element's position.
+    Position insertAfter(const Position& position, const T& value) {
+        Block* b = position.block ? position.block : first;
+        size_t index = position.block ? position.index + 1 : 0;
+        if (!b) {
+            b = addBlockAfter(nullptr);
+        } else if (index == CAPACITY) {
+            b = b->next && b->next->count < CAPACITY ? b->next : addBlockAfter(b);
+            index = 0;
+        }
+        if (b->count == CAPACITY) {
+            Block* upper = addBlockAfter(b);
+            const size_t HALF = CAPACITY / 2;
+            for (size_t i = HALF; i < CAPACITY; i++) {
+                upper->items[i - HALF] = std::move(b->items[i]);
+            }
+            upper->count = CAPACITY - HALF;
+            b->count = HALF;
+            if (index > HALF) {
+                b = upper;
+                index -= HALF;
             }
-            current->next = newTask;
-            current = newTask;
         }
+        for (size_t i = b->count; i > index; i--) {
+            b->items[i] = std::move(b->items[i - 1]);
+        }
+        b->items[index] = value;
+        b->count++;
+        total++;
+        return Position(b, index);
+    }
+
+    // Append at the end
+    Position pushBack(const T& value) { return insertAfter(back(), value); }
+
+    // Remove the element at position. A block left empty is freed, and one
+    // that drops to half capacity with its neighbour is merged into it.
+    // tracked (another element's position) is updated to stay on its element.
+    void erase(const Position& position, Position& tracked) {
+        Block* b = position.block;
+        for (size_t i = position.index; i + 1 < b->count; i++) {
+            b->items[i] = std::move(b->items[i + 1]);
+        }
+        b->count--;
+        b->items[b->count] = T();
+        total--;
+        if (tracked.block == b && tracked.index > position.index) {
+            tracked.index--;
+        }
+        if (b->count == 0) {
+            removeBlock(b);
+        } else if (b->next && b->count + b->next->count <= CAPACITY / 2) {
+            mergeInto(b, b->next, tracked);
+        } else if (b->prev && b->prev->count + b->count <= CAPACITY / 2) {
+            mergeInto(b->prev, b, tracked);
+        }
+    }
+
+    // Position of the first element equal to value, or an invalid one
+    Position find(const T& value) const {
+        for (Block* b = first; b; b = b->next) {
+            for (size_t i = 0; i < b->count; i++) {
+                if (b->items[i] == value) {
+                    return Position(b, i);
+                }
+            }
+        }
+        return Position();
+    }
+
+    // Call visit on every element in order
+    template <typename Visitor>
+    void forEach(Visitor visit) const {
+        for (Block* b = first; b; b = b->next) {
+            for (size_t i = 0; i < b->count; i++) {
+                visit(b->items[i]);
+            }
+        }
+    }
+};
+
+// Doubly linked list for to-do list, backed by the unrolled list
+class TaskManager {
+private:
+    typedef UnrolledList<string> TaskList;
+
+    TaskList tasks;
+    TaskList::Position current;
+
+public:
+    // Add a new task
+    void addTask(string description) {
+        current = tasks.insertAfter(current, description);
         cout << "Added task: " << description << "\n";
     }
 
     // Remove task by description
     void removeTask(string description) {
-        Task* temp = head;
-        while (temp && temp->description != description) {
-            temp = temp->next;
-        }
-        if (!temp) {
+        TaskList::Position target = tasks.find(description);
+        if (!target.valid()) {
             cout << "Task not found!\n";
             return;
         }
-        if (temp == current) {
-            current = temp->prev ? temp->prev : temp->next;
-        }
-        if (temp == head) {
-            head = temp->next;
-        }
-        if (temp->prev) {
-            temp->prev->next = temp->next;
-        }
-        if (temp->next) {
-            temp->next->prev = temp->prev;
+        if (target == current) {
+            TaskList::Position before = tasks.prev(target);
+            current = before.valid() ? before : tasks.next(target);
         }
+        tasks.erase(target, current);
         cout << "Removed task: " << description << "\n";
-        delete temp;
     }
 
     // Navigate to previous task
     void goBack() {
-        if (!current || !current->prev) {
+        TaskList::Position before = current.valid() ? tasks.prev(current) : TaskList::Position();
+        if (!before.valid()) {
             cout << "No previous task!\n";
             return;
         }
-        current = current->prev;
-        cout << "Current task: " << current->description << "\n";
+        current = before;
+        cout << "Current task: " << tasks[current] << "\n";
     }
 
     // Navigate to next task
     void goForward() {
-        if (!current || !current->next) {
+        TaskList::Position after = current.valid() ? tasks.next(current) : TaskList::Position();
+        if (!after.valid()) {
             cout << "No next task!\n";
             return;
         }
-        current = current->next;
-        cout << "Current task: " << current->description << "\n";
+        current = after;
+        cout << "Current task: " << tasks[current] << "\n";
     }
 
     // Display all tasks
     void displayTasks() {
-        if (!head) {
+        if (tasks.empty()) {
             cout << "To-Do List is empty!\n";
             return;
         }
         cout << "\n===== To-Do List =====\n";
-        Task* temp = head;
         int count = 1;
-        while (temp) {
-            cout << count++ << ". " << temp->description;
-            if (temp == current) {
+        for (TaskList::Position p = tasks.begin(); p.valid(); p = tasks.next(p)) {
+            cout << count++ << ". " << tasks[p];
+            if (p == current) {
                 cout << " (current)";
             }
             cout << "\n";
-            temp = temp->next;
         }
         cout << "=====================\n\n";
     }
 
     // Show current task
     void showCurrentTask() {
-        if (!current) {
+        if (!current.valid()) {
             cout << "No tasks in the list!\n";
             return;
         }
-        cout << "Current task: " << current->description << "\n";
+        cout << "Current task: " << tasks[current] << "\n";
     }
+};
 
-    ~TaskManager() {
-        Task* temp = head;
-        while (temp) {
-            Task* next = temp->next;
-            delete temp;
-            temp = next;
+// Seconds elapsed since a start time
+double secondsSince(chrono::steady_clock::time_point start) {
+    return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+// Link one node per task in the order given
+Task* linkTasks(const vector<Task*>& order) {
+    for (size_t i = 0; i < order.size(); i++) {
+        order[i]->prev = i > 0 ? order[i - 1] : nullptr;
+        order[i]->next = i + 1 < order.size() ? order[i + 1] : nullptr;
+    }
+    return order.empty() ? nullptr : order[0];
+}
+
+// Walk a large to-do list front to back, summing description lengths:
+// one node per task (allocated in list order, and in shuffled order as
+// after a long session of inserts and removals) vs the unrolled list
+void runBenchmarks() {
+    const int PASSES = 5;
+    volatile size_t checksum = 0;
+
+    cout << "\n===== Traversing large to-do lists (" << PASSES << " passes) =====\n";
+    cout << left << setw(12) << "Tasks" << setw(30) << "List" << right << setw(12) << "Build ms" << setw(14)
+         << "ns per task" << setw(12) << "Memory MB" << "\n" << left;
+
+    for (size_t count : {100000, 1000000}) {
+        vector<string> descriptions;
+        for (size_t i = 0; i < count; i++) {
+            descriptions.push_back("Task " + to_string(i));
+        }
+        auto printRow = [&](const string& name, double buildSeconds, double walkSeconds, size_t bytes) {
+            cout << setw(12) << count << setw(30) << name << right << fixed << setprecision(2) << setw(12)
+                 << buildSeconds * 1000 << setw(14) << walkSeconds * 1e9 / (PASSES * count) << setw(12)
+                 << bytes / 1048576.0 << "\n" << left;
+        };
+        auto walkNodes = [&](Task* head) {
+            size_t total = 0;
+            auto start = chrono::steady_clock::now();
+            for (int pass = 0; pass < PASSES; pass++) {
+                for (Task* task = head; task; task = task->next) {
+                    total += task->description.size();
+                }
+            }
+            double seconds = secondsSince(start);
+            checksum = checksum + total;
+            return seconds;
+        };
+
+        for (bool shuffled : {false, true}) {
+            auto start = chrono::steady_clock::now();
+            vector<Task*> nodes;
+            nodes.reserve(count);
+            for (const string& description : descriptions) {
+                nodes.push_back(new Task(description));
+            }
+            if (shuffled) {
+                mt19937 rng(count);
+                shuffle(nodes.begin(), nodes.end(), rng);
+            }
+            Task* head = linkTasks(nodes);
+            double buildSeconds = secondsSince(start);
+            double walkSeconds = walkNodes(head);
+            printRow(shuffled ? "Node per task, shuffled" : "Node per task, in order", buildSeconds, walkSeconds,
+                     count * (sizeof(Task) + 16));
+            for (Task* task : nodes) {
+                delete task;
+            }
+        }
+
+        {
+            auto start = chrono::steady_clock::now();
+            UnrolledList<string> tasks;
+            for (const string& description : descriptions) {
+                tasks.pushBack(description);
+            }
+            double buildSeconds = secondsSince(start);
+            size_t total = 0;
+            start = chrono::steady_clock::now();
+            for (int pass = 0; pass < PASSES; pass++) {
+                tasks.forEach([&total](const string& description) { total += description.size(); });
+            }
+            double walkSeconds = secondsSince(start);
+            checksum = checksum + total;
+            printRow("Unrolled, 16 per block", buildSeconds, walkSeconds, tasks.bytesReserved());
         }
     }
-};
+    cout << "=====================================\n";
+}
 
 // Function to display the menu
 void displayMenu() {
@@ -131,8 +446,9 @@ void displayMenu() {
     cout << "4. Navigate to next task\n";
     cout << "5. Display all tasks\n";
     cout << "6. Show current task\n";
-    cout << "7. Exit\n";
-    cout << "Enter your choice (1-7): ";
+    cout << "7. Run traversal benchmark\n";
+    cout << "8. Exit\n";
+    cout << "Enter your choice (1-8): ";
 }
 
 // Function to clear input buffer
@@ -189,12 +505,16 @@ int main() {
                 break;
                 
             case 7:  
+                runBenchmarks();
+                break;
+                
+            case 8:  
                 cout << "Exiting Task Manager. Goodbye!\n";
                 running = false;
                 break;
                 
             default:
-                cout << "Invalid choice. Please enter a number between 1 and 7.\n";
+                cout << "Invalid choice. Please enter a number between 1 and 8.\n";
         }
     }
 
@@ -2,6 +2,21 @@
 #include <string>
 #include <vector>
 #include <limits>
+#include <cstdint>
+#include <chrono>
+#include <random>
+#include <iomanip>
+#include <algorithm>
+#include <iterator>
+#include <sstream>
+#include <atomic>
+#include <thread>
+#include <memory>
+#include <cstdlib>
+#include <cstring>
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
 
 using namespace std;
 
@@ -9,51 +24,381 @@ using namespace std;
 struct Patient {
     string name;
     int priority;  // Lower number means higher medical priority (1 = most urgent)
+    Patient() : priority(0) {}
     Patient(string n, int p) : name(n), priority(p) {}
 };
 
-// Min-Heap for ER prioritization
-class ERPriority {
+// Heap slot: the only data moved by heapifyUp/heapifyDown
+struct HeapEntry {
+    int priority;
+    int handle;
+};
+
+// Indexed D-ary min-heap of patients.
+// Patients stay put in a handle-indexed table; the heap itself only moves
+// small (priority, handle) entries, and a handle -> position map lets
+// updatePriority and remove find any patient in O(1) and fix the heap in
+// O(log n). Handles of removed patients are recycled.
+template <int D>
+class IndexedDaryHeap {
 private:
-    vector<Patient> heap;
+    vector<HeapEntry> heap;
+    vector<int> position;      // Heap index of each handle, -1 if unused
+    vector<Patient> patients;  // Payload of each handle
+    vector<int> freeHandles;
 
-    // Get parent, left, and right child indices
-    int parent(int index) { return (index - 1) / 2; }
-    int leftChild(int index) { return 2 * index + 1; }
-    int rightChild(int index) { return 2 * index + 2; }
+    int parent(int index) { return (index - 1) / D; }
+    int firstChild(int index) { return D * index + 1; }
 
-    // Heapify up
+    void place(int index, HeapEntry entry) {
+        heap[index] = entry;
+        position[entry.handle] = index;
+    }
+
+    // Move the entry at index up until its parent is no larger
     void heapifyUp(int index) {
-        while (index > 0 && heap[parent(index)].priority > heap[index].priority) {
-            swap(heap[index], heap[parent(index)]);
+        HeapEntry entry = heap[index];
+        while (index > 0 && heap[parent(index)].priority > entry.priority) {
+            place(index, heap[parent(index)]);
             index = parent(index);
         }
+        place(index, entry);
     }
 
-    // Heapify down
+    // Move the entry at index down until no child is smaller
     void heapifyDown(int index) {
-        int minIndex = index;
-        int left = leftChild(index);
-        int right = rightChild(index);
+        HeapEntry entry = heap[index];
+        int size = heap.size();
+        while (true) {
+            int first = firstChild(index);
+            if (first >= size) {
+                break;
+            }
+            int last = min(first + D, size);
+            int minChild = first;
+            for (int child = first + 1; child < last; child++) {
+                if (heap[child].priority < heap[minChild].priority) {
+                    minChild = child;
+                }
+            }
+            if (heap[minChild].priority >= entry.priority) {
+                break;
+            }
+            place(index, heap[minChild]);
+            index = minChild;
+        }
+        place(index, entry);
+    }
 
-        if (left < heap.size() && heap[left].priority < heap[minIndex].priority) {
-            minIndex = left;
+    // Restore heap order over the whole array bottom-up (Floyd), O(n)
+    void buildHeap() {
+        if (heap.empty()) {
+            return;
+        }
+        for (int i = (int)heap.size() - 1; i >= 0; i--) {
+            position[heap[i].handle] = i;
         }
-        if (right < heap.size() && heap[right].priority < heap[minIndex].priority) {
-            minIndex = right;
+        for (int i = parent((int)heap.size() - 1); i >= 0; i--) {
+            heapifyDown(i);
         }
-        if (index != minIndex) {
-            swap(heap[index], heap[minIndex]);
-            heapifyDown(minIndex);
+    }
+
+    // Restore heap order after entries were appended at [from, size).
+    // Only ancestors of the new entries can be out of order; they form one
+    // contiguous index range per level, fixed bottom-up as in Floyd's
+    // method. Cost is O(k + log^2 n) for k new entries instead of
+    // O(k log n) for k separate sift-ups.
+    void heapifyAppended(int from) {
+        int low = from;
+        int high = (int)heap.size() - 1;
+        while (high > 0) {
+            low = parent(low);
+            high = parent(high);
+            for (int i = high; i >= low; i--) {
+                heapifyDown(i);
+            }
         }
     }
 
+    int allocateHandle(const string& name, int priority) {
+        int handle;
+        if (!freeHandles.empty()) {
+            handle = freeHandles.back();
+            freeHandles.pop_back();
+            patients[handle] = Patient(name, priority);
+        } else {
+            handle = patients.size();
+            patients.push_back(Patient(name, priority));
+            position.push_back(-1);
+        }
+        return handle;
+    }
+
+    // Take the entry at index out of the heap and release its handle
+    Patient removeAt(int index) {
+        int handle = heap[index].handle;
+        Patient patient = std::move(patients[handle]);
+        position[handle] = -1;
+        freeHandles.push_back(handle);
+
+        HeapEntry last = heap.back();
+        heap.pop_back();
+        if (index < (int)heap.size()) {
+            place(index, last);
+            if (index > 0 && heap[parent(index)].priority > last.priority) {
+                heapifyUp(index);
+            } else {
+                heapifyDown(index);
+            }
+        }
+        return patient;
+    }
+
 public:
-    // Insert patient
-    void insert(string name, int priority) {
-        heap.push_back(Patient(name, priority));
+    bool empty() const { return heap.empty(); }
+    size_t size() const { return heap.size(); }
+    bool contains(int handle) const {
+        return handle >= 0 && handle < (int)position.size() && position[handle] != -1;
+    }
+
+    // Add a patient and return its handle
+    int push(const string& name, int priority) {
+        int handle = allocateHandle(name, priority);
+        heap.push_back({priority, handle});
         heapifyUp(heap.size() - 1);
-        cout << "Added patient: " << name << " (Priority Level: " << priority << ") - ";
+        return handle;
+    }
+
+    // Add a range of patients and return their handles in the same order.
+    // Everything is appended first and heap order is restored once with a
+    // partial bottom-up heapify over the ancestors of the new entries.
+    template <typename Iterator>
+    vector<int> pushBatch(Iterator first, Iterator last) {
+        size_t oldSize = heap.size();
+        size_t count = distance(first, last);
+        vector<int> handles;
+        handles.reserve(count);
+        heap.reserve(oldSize + count);
+        patients.reserve(patients.size() + count);
+        position.reserve(position.size() + count);
+        for (; first != last; ++first) {
+            int handle = allocateHandle(first->name, first->priority);
+            position[handle] = heap.size();
+            heap.push_back({first->priority, handle});
+            handles.push_back(handle);
+        }
+        heapifyAppended(oldSize);
+        return handles;
+    }
+
+    // Remove and return the k most urgent patients, most urgent first.
+    // When k is a large share of the queue it is cheaper to select the k
+    // smallest entries in one O(n) pass, sort only those and rebuild the
+    // rest in O(n) than to pay k separate O(log n) extractions.
+    // If handles is given, it receives the released handle of each patient.
+    vector<Patient> popTopK(size_t k, vector<int>* handles = nullptr) {
+        k = min(k, heap.size());
+        vector<Patient> result;
+        result.reserve(k);
+        if (k * 2 < heap.size()) {
+            while (result.size() < k) {
+                if (handles) {
+                    handles->push_back(topHandle());
+                }
+                result.push_back(pop());
+            }
+            return result;
+        }
+
+        auto byPriority = [](const HeapEntry& a, const HeapEntry& b) { return a.priority < b.priority; };
+        nth_element(heap.begin(), heap.begin() + k, heap.end(), byPriority);
+        sort(heap.begin(), heap.begin() + k, byPriority);
+        for (size_t i = 0; i < k; i++) {
+            int handle = heap[i].handle;
+            if (handles) {
+                handles->push_back(handle);
+            }
+            result.push_back(std::move(patients[handle]));
+            position[handle] = -1;
+            freeHandles.push_back(handle);
+        }
+        heap.erase(heap.begin(), heap.begin() + k);
+        buildHeap();
+        return result;
+    }
+
+    const Patient& top() const { return patients[heap[0].handle]; }
+    int topHandle() const { return heap[0].handle; }
+
+    // Remove and return the most urgent patient
+    Patient pop() { return removeAt(0); }
+
+    // Change a waiting patient's priority; false if the handle is not queued
+    bool updatePriority(int handle, int priority) {
+        if (!contains(handle)) {
+            return false;
+        }
+        int index = position[handle];
+        int old = heap[index].priority;
+        heap[index].priority = priority;
+        patients[handle].priority = priority;
+        if (priority < old) {
+            heapifyUp(index);
+        } else if (priority > old) {
+            heapifyDown(index);
+        }
+        return true;
+    }
+
+    // Remove a waiting patient; false if the handle is not queued
+    bool remove(int handle) {
+        if (!contains(handle)) {
+            return false;
+        }
+        removeAt(position[handle]);
+        return true;
+    }
+
+    const Patient& patient(int handle) const { return patients[handle]; }
+
+    // Handle stored at a heap position, for walking the heap in array order
+    int handleAt(size_t index) const { return heap[index].handle; }
+};
+
+// Hierarchical timing wheel on a logical clock.
+// Level l has 64 slots of 64^l ticks each. A timer goes into the coarsest
+// level whose span covers its delay, and when the clock reaches the start of
+// a coarse slot its timers are cascaded down to finer levels. Each timer
+// moves at most LEVELS times, so schedule and firing are amortized O(1).
+// There is no cancel: owners drop stale timers when they fire.
+template <typename T>
+class TimingWheel {
+private:
+    static const int SLOT_BITS = 6;
+    static const int SLOTS = 1 << SLOT_BITS;
+    static const int LEVELS = 4;  // 64^4 ticks
+
+    struct Timer {
+        uint64_t deadline;
+        T item;
+    };
+
+    vector<Timer> slots[LEVELS][SLOTS];
+    uint64_t now;
+    size_t count;
+
+    void place(const Timer& timer) {
+        uint64_t delay = timer.deadline > now ? timer.deadline - now : 0;
+        int level = 0;
+        while (level < LEVELS - 1 && delay >= (uint64_t(1) << (SLOT_BITS * (level + 1)))) {
+            level++;
+        }
+        uint64_t deadline = timer.deadline;
+        if (level == LEVELS - 1 && delay >= (uint64_t(1) << (SLOT_BITS * LEVELS))) {
+            // Beyond the wheel: park in the furthest slot and re-place on cascade
+            deadline = now + (uint64_t(1) << (SLOT_BITS * LEVELS)) - 1;
+        }
+        slots[level][(deadline >> (SLOT_BITS * level)) & (SLOTS - 1)].push_back(timer);
+    }
+
+public:
+    TimingWheel() : now(0), count(0) {}
+
+    uint64_t time() const { return now; }
+    size_t size() const { return count; }
+
+    // Fire item once the clock reaches deadline (immediately on the next tick
+    // if it is already due)
+    void schedule(uint64_t deadline, const T& item) {
+        place({max(deadline, now + 1), item});
+        count++;
+    }
+
+    // Move the clock forward to time, calling fire(item) for each due timer.
+    // fire may schedule new timers.
+    template <typename Callback>
+    void advanceTo(uint64_t time, Callback fire) {
+        while (now < time) {
+            now++;
+            for (int level = 1; level < LEVELS; level++) {
+                if ((now & ((uint64_t(1) << (SLOT_BITS * level)) - 1)) != 0) {
+                    break;
+                }
+                vector<Timer> cascade;
+                cascade.swap(slots[level][(now >> (SLOT_BITS * level)) & (SLOTS - 1)]);
+                for (const Timer& timer : cascade) {
+                    place(timer);
+                }
+            }
+            vector<Timer> due;
+            due.swap(slots[0][now & (SLOTS - 1)]);
+            count -= due.size();
+            for (const Timer& timer : due) {
+                fire(timer.item);
+            }
+        }
+    }
+};
+
+// Aging timer for a waiting patient; stale once the patient's generation moves on
+struct AgingTimer {
+    int id;
+    unsigned generation;
+};
+
+// Min-Heap for ER prioritization
+class ERPriority {
+private:
+    IndexedDaryHeap<4> heap;
+
+    // Aging: a patient who waits agingThreshold[level] minutes at a level is
+    // promoted one level, so low-priority patients cannot starve. Timers live
+    // in a timing wheel; re-triage, removal or treatment bumps the patient's
+    // generation so their pending timer is ignored when it fires.
+    TimingWheel<AgingTimer> agingTimers;
+    int agingThreshold[6];
+    vector<uint64_t> arrivalMinute;  // Per ID
+    vector<int> triageLevel;         // Per ID, priority given at arrival
+    vector<unsigned> generation;     // Per ID
+    vector<int> waitTimes[6];        // Minutes waited by treated patients, per triage level
+
+    void trackArrival(int id, int priority) {
+        if (id >= (int)generation.size()) {
+            arrivalMinute.resize(id + 1);
+            triageLevel.resize(id + 1);
+            generation.resize(id + 1, 0);
+        }
+        arrivalMinute[id] = agingTimers.time();
+        triageLevel[id] = priority;
+        scheduleAging(id, priority);
+    }
+
+    void scheduleAging(int id, int priority) {
+        generation[id]++;
+        if (priority > 1) {
+            agingTimers.schedule(agingTimers.time() + agingThreshold[priority], {id, generation[id]});
+        }
+    }
+
+    void recordTreatment(int id) {
+        generation[id]++;
+        waitTimes[triageLevel[id]].push_back(agingTimers.time() - arrivalMinute[id]);
+    }
+
+public:
+    ERPriority() {
+        // Minutes at a level before promotion; level 1 is never promoted
+        int defaults[6] = {0, 0, 15, 30, 60, 120};
+        for (int level = 0; level <= 5; level++) {
+            agingThreshold[level] = defaults[level];
+        }
+    }
+
+    // Insert patient and return the ID used to re-triage or remove them
+    int insert(string name, int priority) {
+        int id = heap.push(name, priority);
+        trackArrival(id, priority);
+        cout << "Added patient: " << name << " (ID: " << id << ", Priority Level: " << priority << ") - ";
         
         // Provide context for the priority level
         if (priority == 1) {
@@ -67,6 +412,7 @@ public:
         } else {
             cout << "Non-urgent\n";
         }
+        return id;
     }
 
     // Extract highest priority patient (lowest number)
@@ -75,12 +421,128 @@ public:
             cout << "No patients in queue!\n";
             return;
         }
-        cout << "Treating: " << heap[0].name << " (Priority Level: " << heap[0].priority << ")\n";
-        heap[0] = heap.back();
-        heap.pop_back();
-        if (!heap.empty()) {
-            heapifyDown(0);
+        int id = heap.topHandle();
+        recordTreatment(id);
+        Patient patient = heap.pop();
+        cout << "Treating: " << patient.name << " (Priority Level: " << patient.priority
+             << ", waited " << agingTimers.time() - arrivalMinute[id] << " min)\n";
+    }
+
+    // Mass-casualty intake: add a whole group of patients at once
+    void insertBatch(const vector<Patient>& arrivals) {
+        vector<int> ids = heap.pushBatch(arrivals.begin(), arrivals.end());
+        for (size_t i = 0; i < ids.size(); i++) {
+            trackArrival(ids[i], arrivals[i].priority);
+        }
+        int perLevel[6] = {0, 0, 0, 0, 0, 0};
+        for (const Patient& patient : arrivals) {
+            perLevel[patient.priority]++;
         }
+        cout << "Added " << arrivals.size() << " patients";
+        if (!ids.empty()) {
+            cout << " (IDs " << ids.front() << "-" << ids.back() << " in arrival order)";
+        }
+        cout << ": ";
+        for (int level = 1; level <= 5; level++) {
+            cout << perLevel[level] << " at level " << level << (level < 5 ? ", " : "\n");
+        }
+    }
+
+    // Treat the k most urgent patients
+    void extractTopK(int k) {
+        if (heap.empty()) {
+            cout << "No patients in queue!\n";
+            return;
+        }
+        vector<int> ids;
+        vector<Patient> treated = heap.popTopK(k, &ids);
+        for (size_t i = 0; i < treated.size(); i++) {
+            recordTreatment(ids[i]);
+            cout << "Treating: " << treated[i].name << " (Priority Level: " << treated[i].priority
+                 << ", waited " << agingTimers.time() - arrivalMinute[ids[i]] << " min)\n";
+        }
+    }
+
+    // Re-triage a waiting patient
+    void updatePriority(int id, int priority) {
+        if (!heap.contains(id)) {
+            cout << "No waiting patient with ID " << id << "!\n";
+            return;
+        }
+        int old = heap.patient(id).priority;
+        heap.updatePriority(id, priority);
+        scheduleAging(id, priority);
+        cout << "Re-triaged " << heap.patient(id).name << ": Priority Level " << old << " -> " << priority << "\n";
+    }
+
+    // Remove a patient who left before treatment
+    void removePatient(int id) {
+        if (!heap.contains(id)) {
+            cout << "No waiting patient with ID " << id << "!\n";
+            return;
+        }
+        string name = heap.patient(id).name;
+        generation[id]++;
+        heap.remove(id);
+        cout << "Removed patient: " << name << " (ID: " << id << ")\n";
+    }
+
+    // Move the ER clock forward, promoting patients whose aging timers fire
+    void advanceClock(int minutes) {
+        int promoted = 0;
+        agingTimers.advanceTo(agingTimers.time() + minutes, [&](const AgingTimer& timer) {
+            if (timer.generation != generation[timer.id] || !heap.contains(timer.id)) {
+                return;  // Treated, removed or re-triaged since this timer was set
+            }
+            int old = heap.patient(timer.id).priority;
+            heap.updatePriority(timer.id, old - 1);
+            scheduleAging(timer.id, old - 1);
+            cout << "Aged: " << heap.patient(timer.id).name << " waited "
+                 << agingTimers.time() - arrivalMinute[timer.id] << " min, Priority Level " << old << " -> "
+                 << old - 1 << "\n";
+            promoted++;
+        });
+        cout << "Clock is now at minute " << agingTimers.time() << " (" << promoted << " patients promoted)\n";
+    }
+
+    // Minutes a patient may wait at a level before being promoted
+    void setAgingThreshold(int level, int minutes) {
+        if (level < 2 || level > 5 || minutes < 1) {
+            cout << "Aging applies to levels 2-5 with a threshold of at least 1 minute!\n";
+            return;
+        }
+        agingThreshold[level] = minutes;
+        cout << "Patients at level " << level << " are promoted after " << minutes << " min "
+             << "(applies to timers set from now on)\n";
+    }
+
+    // Wait-time percentiles of treated patients, by triage level at arrival
+    void displayWaitTimes() {
+        cout << "\n===== Wait Times (minutes, by triage level) =====\n";
+        cout << left << setw(8) << "Level" << setw(10) << "Treated" << setw(8) << "p50" << setw(8) << "p90"
+             << setw(8) << "p99" << setw(8) << "Max" << "Aging after\n";
+        for (int level = 1; level <= 5; level++) {
+            vector<int> waits = waitTimes[level];
+            cout << setw(8) << level << setw(10) << waits.size();
+            if (waits.empty()) {
+                cout << setw(8) << "-" << setw(8) << "-" << setw(8) << "-" << setw(8) << "-";
+            } else {
+                sort(waits.begin(), waits.end());
+                // Nearest-rank percentile
+                for (int percent : {50, 90, 99}) {
+                    size_t rank = (waits.size() * percent + 99) / 100;
+                    cout << setw(8) << waits[max<size_t>(rank, 1) - 1];
+                }
+                cout << setw(8) << waits.back();
+            }
+            if (level == 1) {
+                cout << "-\n";
+            } else {
+                cout << agingThreshold[level] << " min\n";
+            }
+        }
+        cout << "Clock: minute " << agingTimers.time() << ", " << heap.size() << " waiting\n";
+        cout << "=================================================\n\n";
     }
 
     // Display heap
@@ -92,16 +554,18 @@ public:
         cout << "\n===== ER Priority Queue =====\n";
         cout << "Priority scale: 1 (most urgent) to 5 (least urgent)\n";
         for (size_t i = 0; i < heap.size(); i++) {
-            cout << i+1 << ". Patient: " << heap[i].name << ", Priority Level: " << heap[i].priority;
+            int id = heap.handleAt(i);
+            const Patient& patient = heap.patient(id);
+            cout << i+1 << ". Patient: " << patient.name << " (ID: " << id << "), Priority Level: " << patient.priority;
             
             // Add context for each priority level
-            if (heap[i].priority == 1) {
+            if (patient.priority == 1) {
                 cout << " (Immediate care)";
-            } else if (heap[i].priority == 2) {
+            } else if (patient.priority == 2) {
                 cout << " (Very urgent)";
-            } else if (heap[i].priority == 3) {
+            } else if (patient.priority == 3) {
                 cout << " (Urgent)";
-            } else if (heap[i].priority == 4) {
+            } else if (patient.priority == 4) {
                 cout << " (Standard)";
             } else {
                 cout << " (Non-urgent)";
@@ -112,14 +576,917 @@ public:
     }
 };
 
+// Index of the lowest set bit of a non-zero mask
+inline int lowestSetBit(uint64_t mask) {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_ctzll(mask);
+#else
+    int bit = 0;
+    while (!(mask & 1)) {
+        mask >>= 1;
+        bit++;
+    }
+    return bit;
+#endif
+}
+
+// Priority queue for a small, fixed priority scale (1..Levels).
+// Each level is a FIFO ring buffer, so patients with equal priority are
+// served in arrival order, and a bitmask of non-empty levels finds the most
+// urgent one with a single bit scan: push and pop are O(1).
+template <typename T, int Levels>
+class BucketQueue {
+    static_assert(Levels >= 1 && Levels <= 64, "BucketQueue supports 1 to 64 priority levels");
+
+private:
+    // Growable FIFO ring with power-of-two capacity
+    struct Ring {
+        vector<T> items;
+        size_t head;
+        size_t count;
+
+        Ring() : head(0), count(0) {}
+
+        void push(T item) {
+            if (count == items.size()) {
+                vector<T> grown(items.empty() ? 16 : items.size() * 2);
+                for (size_t i = 0; i < count; i++) {
+                    grown[i] = std::move(items[(head + i) & (items.size() - 1)]);
+                }
+                items.swap(grown);
+                head = 0;
+            }
+            items[(head + count) & (items.size() - 1)] = std::move(item);
+            count++;
+        }
+
+        T pop() {
+            T item = std::move(items[head]);
+            head = (head + 1) & (items.size() - 1);
+            count--;
+            return item;
+        }
+    };
+
+    Ring levels[Levels];
+    uint64_t nonEmpty;
+    size_t total;
+
+public:
+    BucketQueue() : nonEmpty(0), total(0) {}
+
+    bool empty() const { return total == 0; }
+    size_t size() const { return total; }
+
+    // Add an item at priority 1 (most urgent) to Levels
+    void push(T item, int priority) {
+        int level = priority - 1;
+        levels[level].push(std::move(item));
+        nonEmpty |= uint64_t(1) << level;
+        total++;
+    }
+
+    int topPriority() const { return lowestSetBit(nonEmpty) + 1; }
+    const T& top() const {
+        const Ring& ring = levels[lowestSetBit(nonEmpty)];
+        return ring.items[ring.head];
+    }
+
+    // Remove and return the oldest item of the most urgent level
+    T pop() {
+        int level = lowestSetBit(nonEmpty);
+        T item = levels[level].pop();
+        if (levels[level].count == 0) {
+            nonEmpty &= ~(uint64_t(1) << level);
+        }
+        total--;
+        return item;
+    }
+};
+
+// Structure-of-arrays 8-ary min-heap for very large queues.
+// Heap order is kept on a tight array of 64-bit keys (priority in the high
+// bits, arrival sequence below), with a parallel array of 32-bit payload IDs;
+// the Patient records themselves live in a separate table and are never
+// touched while sifting. Node i is stored at slot i + 7, which puts each
+// group of 8 siblings on exactly one 64-byte cache line, so choosing the
+// minimum child costs one cache miss per level. With UseSimd (and AVX2) the
+// eight children are compared with two vector compares instead of a loop.
+template <bool UseSimd>
+class AlignedKeyHeap {
+private:
+    static const int D = 8;
+    static const int OFFSET = D - 1;
+    static const uint64_t SENTINEL = 0x7FFFFFFFFFFFFFFFULL;  // Fills unused slots
+
+    uint64_t* keys;
+    uint32_t* ids;
+    size_t count;
+    size_t capacity;  // Slots allocated, always a multiple of D
+    uint64_t sequence;
+    vector<Patient> payloads;
+    vector<uint32_t> freeIds;
+
+    static size_t slot(size_t index) { return index + OFFSET; }
+
+    void grow() {
+        size_t newCapacity = capacity == 0 ? 64 : capacity * 2;
+        uint64_t* newKeys = static_cast<uint64_t*>(aligned_alloc(64, newCapacity * sizeof(uint64_t)));
+        uint32_t* newIds = static_cast<uint32_t*>(aligned_alloc(64, newCapacity * sizeof(uint32_t)));
+        for (size_t i = 0; i < newCapacity; i++) {
+            newKeys[i] = SENTINEL;
+        }
+        if (capacity > 0) {
+            memcpy(newKeys, keys, capacity * sizeof(uint64_t));
+            memcpy(newIds, ids, capacity * sizeof(uint32_t));
+        }
+        free(keys);
+        free(ids);
+        keys = newKeys;
+        ids = newIds;
+        capacity = newCapacity;
+    }
+
+    // Slot of the smallest key among the 8 children starting at slot first
+    size_t minChild(size_t first) const {
+#ifdef __AVX2__
+        if (UseSimd) {
+            const __m256i* line = reinterpret_cast<const __m256i*>(keys + first);
+            __m256i low = _mm256_load_si256(line);
+            __m256i high = _mm256_load_si256(line + 1);
+            __m256i minimum = _mm256_blendv_epi8(low, high, _mm256_cmpgt_epi64(low, high));
+            __m256i swapped = _mm256_permute4x64_epi64(minimum, _MM_SHUFFLE(1, 0, 3, 2));
+            minimum = _mm256_blendv_epi8(minimum, swapped, _mm256_cmpgt_epi64(minimum, swapped));
+            swapped = _mm256_shuffle_epi32(minimum, _MM_SHUFFLE(1, 0, 3, 2));
+            minimum = _mm256_blendv_epi8(minimum, swapped, _mm256_cmpgt_epi64(minimum, swapped));
+            int lowMask = _mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpeq_epi64(low, minimum)));
+            int highMask = _mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpeq_epi64(high, minimum)));
+            return first + lowestSetBit(lowMask | (highMask << 4));
+        }
+#endif
+        size_t best = first;
+        for (size_t child = first + 1; child < first + D; child++) {
+            if (keys[child] < keys[best]) {
+                best = child;
+            }
+        }
+        return best;
+    }
+
+public:
+    AlignedKeyHeap() : keys(nullptr), ids(nullptr), count(0), capacity(0), sequence(0) {}
+    ~AlignedKeyHeap() {
+        free(keys);
+        free(ids);
+    }
+    AlignedKeyHeap(const AlignedKeyHeap&) = delete;
+    AlignedKeyHeap& operator=(const AlignedKeyHeap&) = delete;
+
+    static bool simdEnabled() {
+#ifdef __AVX2__
+        return UseSimd;
+#else
+        return false;
+#endif
+    }
+
+    bool empty() const { return count == 0; }
+    size_t size() const { return count; }
+    const Patient& top() const { return payloads[ids[slot(0)]]; }
+
+    // Add a patient; priority must be below 2^23
+    void push(const string& name, int priority) {
+        // A full sibling group must exist behind the new node's slot
+        while (slot(count) + D >= capacity) {
+            grow();
+        }
+        uint32_t id;
+        if (!freeIds.empty()) {
+            id = freeIds.back();
+            freeIds.pop_back();
+            payloads[id] = Patient(name, priority);
+        } else {
+            id = payloads.size();
+            payloads.push_back(Patient(name, priority));
+        }
+        uint64_t key = (uint64_t(priority) << 40) | (sequence++ & ((uint64_t(1) << 40) - 1));
+
+        size_t index = count++;
+        while (index > 0) {
+            size_t parentIndex = (index - 1) / D;
+            if (keys[slot(parentIndex)] <= key) {
+                break;
+            }
+            keys[slot(index)] = keys[slot(parentIndex)];
+            ids[slot(index)] = ids[slot(parentIndex)];
+            index = parentIndex;
+        }
+        keys[slot(index)] = key;
+        ids[slot(index)] = id;
+    }
+
+    // Remove and return the most urgent patient
+    Patient pop() {
+        uint32_t topId = ids[slot(0)];
+        Patient patient = std::move(payloads[topId]);
+        freeIds.push_back(topId);
+
+        count--;
+        uint64_t key = keys[slot(count)];
+        uint32_t id = ids[slot(count)];
+        keys[slot(count)] = SENTINEL;
+
+        size_t index = 0;
+        while (D * index + 1 < count) {
+            size_t child = minChild(slot(D * index + 1));
+            if (keys[child] >= key) {
+                break;
+            }
+            keys[slot(index)] = keys[child];
+            ids[slot(index)] = ids[child];
+            index = child - OFFSET;
+        }
+        if (count > 0) {
+            keys[slot(index)] = key;
+            ids[slot(index)] = id;
+        }
+        return patient;
+    }
+};
+
+// Pairing heap for ward queues that get consolidated.
+// Nodes come from a chunked pool owned by the heap. meld links the two roots
+// and takes over the other heap's pool, so it is O(1) and handles from both
+// heaps stay valid afterwards. push, top, meld and decreaseKey are O(1);
+// pop is O(log n) amortized via two-pass pairing. Equal priorities are
+// served in arrival order.
+template <typename T>
+class PairingHeap {
+public:
+    struct Node {
+        T value;
+        int priority;
+        uint64_t sequence;
+        Node* child;
+        Node* sibling;
+        Node* prev;  // Parent for a first child, otherwise the left sibling
+    };
+    typedef Node* Handle;
+
+private:
+    static const int CHUNK_SIZE = 1024;
+    struct Chunk {
+        Node nodes[CHUNK_SIZE];
+        Chunk* next;
+    };
+
+    Node* root;
+    size_t count;
+    uint64_t sequence;
+    Chunk* chunks;     // Newest first; only the head can have unused nodes
+    Chunk* lastChunk;
+    int headUsed;      // Nodes handed out from the head chunk
+    Node* freeHead;    // Released nodes, linked through sibling
+    Node* freeTail;
+    vector<Node*> pairs;  // Scratch space for pop
+
+    static bool before(const Node* a, const Node* b) {
+        return a->priority < b->priority || (a->priority == b->priority && a->sequence < b->sequence);
+    }
+
+    // Make the root that comes later the first child of the other one
+    static Node* link(Node* a, Node* b) {
+        if (before(b, a)) {
+            swap(a, b);
+        }
+        b->prev = a;
+        b->sibling = a->child;
+        if (a->child) {
+            a->child->prev = b;
+        }
+        a->child = b;
+        return a;
+    }
+
+    Node* allocate() {
+        if (freeHead) {
+            Node* node = freeHead;
+            freeHead = node->sibling;
+            if (!freeHead) {
+                freeTail = nullptr;
+            }
+            return node;
+        }
+        if (!chunks || headUsed == CHUNK_SIZE) {
+            Chunk* chunk = new Chunk();
+            chunk->next = chunks;
+            chunks = chunk;
+            if (!lastChunk) {
+                lastChunk = chunk;
+            }
+            headUsed = 0;
+        }
+        return &chunks->nodes[headUsed++];
+    }
+
+    void release(Node* node) {
+        node->sibling = freeHead;
+        freeHead = node;
+        if (!freeTail) {
+            freeTail = node;
+        }
+    }
+
+    // Detach a non-root node, with its subtree, from its parent or left sibling
+    void cut(Node* node) {
+        if (node->prev->child == node) {
+            node->prev->child = node->sibling;
+        } else {
+            node->prev->sibling = node->sibling;
+        }
+        if (node->sibling) {
+            node->sibling->prev = node->prev;
+        }
+        node->prev = nullptr;
+        node->sibling = nullptr;
+    }
+
+    // Two-pass pairing: link siblings in pairs left to right, then fold the
+    // pairs into one tree right to left
+    Node* mergePairs(Node* first) {
+        if (!first) {
+            return nullptr;
+        }
+        pairs.clear();
+        while (first) {
+            Node* a = first;
+            Node* b = a->sibling;
+            a->prev = nullptr;
+            a->sibling = nullptr;
+            if (!b) {
+                pairs.push_back(a);
+                break;
+            }
+            first = b->sibling;
+            b->prev = nullptr;
+            b->sibling = nullptr;
+            pairs.push_back(link(a, b));
+        }
+        Node* result = pairs.back();
+        for (int i = (int)pairs.size() - 2; i >= 0; i--) {
+            result = link(pairs[i], result);
+        }
+        return result;
+    }
+
+    void reset() {
+        root = nullptr;
+        count = 0;
+        sequence = 0;
+        chunks = nullptr;
+        lastChunk = nullptr;
+        headUsed = 0;
+        freeHead = nullptr;
+        freeTail = nullptr;
+    }
+
+public:
+    PairingHeap() { reset(); }
+    ~PairingHeap() {
+        while (chunks) {
+            Chunk* next = chunks->next;
+            delete chunks;
+            chunks = next;
+        }
+    }
+    PairingHeap(const PairingHeap&) = delete;
+    PairingHeap& operator=(const PairingHeap&) = delete;
+
+    bool empty() const { return root == nullptr; }
+    size_t size() const { return count; }
+    const T& top() const { return root->value; }
+    int topPriority() const { return root->priority; }
+
+    // Add an item and return a handle for decreaseKey
+    Handle push(const T& value, int priority) {
+        Node* node = allocate();
+        node->value = value;
+        node->priority = priority;
+        node->sequence = sequence++;
+        node->child = nullptr;
+        node->sibling = nullptr;
+        node->prev = nullptr;
+        root = root ? link(root, node) : node;
+        count++;
+        return node;
+    }
+
+    // Remove and return the item with the smallest priority
+    T pop() {
+        Node* old = root;
+        T value = std::move(old->value);
+        root = mergePairs(old->child);
+        release(old);
+        count--;
+        return value;
+    }
+
+    // Make a queued item more urgent; false if the new priority is larger
+    bool decreaseKey(Handle node, int priority) {
+        if (priority > node->priority) {
+            return false;
+        }
+        node->priority = priority;
+        if (node != root) {
+            cut(node);
+            root = link(root, node);
+        }
+        return true;
+    }
+
+    // Move every item of other into this heap, leaving other empty
+    void meld(PairingHeap& other) {
+        if (this == &other || !other.chunks) {
+            return;
+        }
+        if (other.root) {
+            root = root ? link(root, other.root) : other.root;
+        }
+        count += other.count;
+        sequence = max(sequence, other.sequence);
+
+        // Other's head chunk joins the middle of our list, so its unused
+        // nodes (at most CHUNK_SIZE) go to the free list
+        for (int i = other.headUsed; i < CHUNK_SIZE; i++) {
+            other.release(&other.chunks->nodes[i]);
+        }
+        if (!chunks) {
+            chunks = other.chunks;
+            lastChunk = other.lastChunk;
+            headUsed = CHUNK_SIZE;
+        } else {
+            other.lastChunk->next = chunks->next;
+            chunks->next = other.chunks;
+            if (lastChunk == chunks) {
+                lastChunk = other.lastChunk;
+            }
+        }
+        if (other.freeHead) {
+            other.freeTail->sibling = freeHead;
+            freeHead = other.freeHead;
+            if (!freeTail) {
+                freeTail = other.freeTail;
+            }
+        }
+        other.reset();
+    }
+};
+
+// Concurrent priority queue shared by several triage desks and treatment
+// rooms. In relaxed mode it is a MultiQueue: several small heaps, each behind
+// its own try-lock. Inserts go to a random heap, and extracts peek at the
+// cached tops of two random heaps and pop the better one. Threads rarely
+// contend, at the price of sometimes serving a slightly less urgent patient
+// first. Strict mode uses a single heap, which gives exact priority order.
+// Equal priorities are served by arrival time in both modes.
+template <typename T>
+class ConcurrentERQueue {
+private:
+    static const uint64_t EMPTY = ~0ULL;
+
+    struct alignas(64) SubQueue {
+        atomic<bool> locked;
+        atomic<uint64_t> topKey;  // Cached minimum key for lock-free peeking
+        vector<pair<uint64_t, T>> heap;
+
+        SubQueue() : locked(false), topKey(EMPTY) {}
+
+        bool tryLock() { return !locked.load(memory_order_relaxed) && !locked.exchange(true, memory_order_acquire); }
+        void unlock() {
+            topKey.store(heap.empty() ? EMPTY : heap.front().first, memory_order_relaxed);
+            locked.store(false, memory_order_release);
+        }
+    };
+
+    static bool laterKey(const pair<uint64_t, T>& a, const pair<uint64_t, T>& b) { return a.first > b.first; }
+
+    vector<unique_ptr<SubQueue>> queues;
+
+    static uint32_t randomNumber() {
+        thread_local uint32_t state = hash<thread::id>()(this_thread::get_id()) | 1;
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        return state;
+    }
+
+    SubQueue& lockRandomQueue() {
+        while (true) {
+            SubQueue& queue = *queues[randomNumber() % queues.size()];
+            if (queue.tryLock()) {
+                return queue;
+            }
+            if (queues.size() == 1) {
+                this_thread::yield();
+            }
+        }
+    }
+
+    // Priority in the top bits, arrival time in nanoseconds below it
+    static uint64_t makeKey(int priority) {
+        uint64_t now = chrono::steady_clock::now().time_since_epoch().count();
+        return (uint64_t(priority) << 56) | (now & ((uint64_t(1) << 56) - 1));
+    }
+
+public:
+    // strict = exact order; otherwise queuesPerThread * threads sub-queues
+    ConcurrentERQueue(bool strict, int threads, int queuesPerThread = 2) {
+        int count = strict ? 1 : max(1, threads * queuesPerThread);
+        for (int i = 0; i < count; i++) {
+            queues.emplace_back(new SubQueue());
+        }
+    }
+
+    void insert(T item, int priority) {
+        uint64_t key = makeKey(priority);
+        SubQueue& queue = lockRandomQueue();
+        queue.heap.push_back(make_pair(key, std::move(item)));
+        push_heap(queue.heap.begin(), queue.heap.end(), laterKey);
+        queue.unlock();
+    }
+
+    // Take an urgent item; false once every sub-queue is empty
+    bool extract(T& item) {
+        int misses = 0;
+        while (true) {
+            SubQueue* first = queues[randomNumber() % queues.size()].get();
+            SubQueue* second = queues[randomNumber() % queues.size()].get();
+            SubQueue* best = first->topKey.load(memory_order_relaxed) <= second->topKey.load(memory_order_relaxed)
+                                 ? first : second;
+            if (best->topKey.load(memory_order_relaxed) == EMPTY) {
+                if (++misses >= 4) {
+                    // Both samples looked empty several times; check everything
+                    bool anyItems = false;
+                    for (auto& queue : queues) {
+                        anyItems = anyItems || queue->topKey.load(memory_order_relaxed) != EMPTY;
+                    }
+                    if (!anyItems) {
+                        return false;
+                    }
+                    misses = 0;
+                }
+                continue;
+            }
+            if (!best->tryLock()) {
+                if (queues.size() == 1) {
+                    this_thread::yield();
+                }
+                continue;
+            }
+            if (best->heap.empty()) {
+                best->unlock();
+                continue;
+            }
+            pop_heap(best->heap.begin(), best->heap.end(), laterKey);
+            item = std::move(best->heap.back().second);
+            best->heap.pop_back();
+            best->unlock();
+            return true;
+        }
+    }
+};
+
+// Seconds elapsed since a start time
+double secondsSince(chrono::steady_clock::time_point start) {
+    return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+void printBenchmarkRow(const string& name, long long operations, double seconds) {
+    cout << left << setw(50) << name << right << fixed << setprecision(1) << setw(9) << seconds * 1000 << " ms"
+         << setprecision(2) << setw(9) << operations / seconds / 1e6 << " Mops/sec\n" << left;
+}
+
+// Bucket queue vs the indexed 4-ary heap on the 1-5 priority scale
+void benchmarkBucketQueue() {
+    const int COUNT = 2000000;
+    const int STEADY_SIZE = 100000;
+    const int STEADY_OPS = 5000000;
+
+    mt19937 rng(7);
+    vector<int> priorities(COUNT + STEADY_OPS);
+    for (int& p : priorities) {
+        p = rng() % 5 + 1;
+    }
+
+    cout << "\n--- Bounded priorities: " << COUNT << " inserts + " << COUNT << " extracts, then "
+         << STEADY_OPS << " insert/extract pairs at " << STEADY_SIZE << " queued ---\n";
+
+    {
+        IndexedDaryHeap<4> heap;
+        auto start = chrono::steady_clock::now();
+        for (int i = 0; i < COUNT; i++) {
+            heap.push("Patient", priorities[i]);
+        }
+        while (!heap.empty()) {
+            heap.pop();
+        }
+        printBenchmarkRow("Indexed 4-ary heap, fill and drain", 2LL * COUNT, secondsSince(start));
+
+        for (int i = 0; i < STEADY_SIZE; i++) {
+            heap.push("Patient", priorities[i]);
+        }
+        start = chrono::steady_clock::now();
+        for (int i = 0; i < STEADY_OPS; i++) {
+            heap.push("Patient", priorities[COUNT + i]);
+            heap.pop();
+        }
+        printBenchmarkRow("Indexed 4-ary heap, steady state", 2LL * STEADY_OPS, secondsSince(start));
+    }
+    {
+        BucketQueue<Patient, 5> queue;
+        auto start = chrono::steady_clock::now();
+        for (int i = 0; i < COUNT; i++) {
+            queue.push(Patient("Patient", priorities[i]), priorities[i]);
+        }
+        while (!queue.empty()) {
+            queue.pop();
+        }
+        printBenchmarkRow("Bucket queue (5 FIFO levels), fill and drain", 2LL * COUNT, secondsSince(start));
+
+        for (int i = 0; i < STEADY_SIZE; i++) {
+            queue.push(Patient("Patient", priorities[i]), priorities[i]);
+        }
+        start = chrono::steady_clock::now();
+        for (int i = 0; i < STEADY_OPS; i++) {
+            queue.push(Patient("Patient", priorities[COUNT + i]), priorities[COUNT + i]);
+            queue.pop();
+        }
+        printBenchmarkRow("Bucket queue (5 FIFO levels), steady state", 2LL * STEADY_OPS, secondsSince(start));
+    }
+}
+
+// Batch intake and top-k extraction vs looping over insert/extract
+void benchmarkBatchOperations() {
+    const int BASE = 1000000;
+    const int BATCH = 500000;
+    const int TOP_K = 900000;
+
+    // Mass-casualty arrivals are mostly critical (levels 1-2)
+    mt19937 rng(11);
+    vector<Patient> base, batch;
+    for (int i = 0; i < BASE; i++) {
+        base.push_back(Patient("Patient", rng() % 5 + 1));
+    }
+    for (int i = 0; i < BATCH; i++) {
+        batch.push_back(Patient("Patient", rng() % 2 + 1));
+    }
+
+    cout << "\n--- Batch operations: " << BATCH << " critical arrivals into " << BASE
+         << " waiting, then the top " << TOP_K << " treated ---\n";
+
+    IndexedDaryHeap<4> looped, batched;
+    looped.pushBatch(base.begin(), base.end());
+    batched.pushBatch(base.begin(), base.end());
+
+    auto start = chrono::steady_clock::now();
+    for (const Patient& patient : batch) {
+        looped.push(patient.name, patient.priority);
+    }
+    printBenchmarkRow("insert in a loop", BATCH, secondsSince(start));
+
+    start = chrono::steady_clock::now();
+    batched.pushBatch(batch.begin(), batch.end());
+    printBenchmarkRow("insertBatch (partial bottom-up heapify)", BATCH, secondsSince(start));
+
+    start = chrono::steady_clock::now();
+    for (int i = 0; i < TOP_K; i++) {
+        looped.pop();
+    }
+    printBenchmarkRow("extract in a loop", TOP_K, secondsSince(start));
+
+    start = chrono::steady_clock::now();
+    batched.popTopK(TOP_K);
+    printBenchmarkRow("extractTopK (select + rebuild)", TOP_K, secondsSince(start));
+
+    // k at least the queue size takes everything and leaves no handle queued
+    size_t rest = batched.size();
+    vector<int> handles;
+    start = chrono::steady_clock::now();
+    vector<Patient> drained = batched.popTopK(rest + 1, &handles);
+    printBenchmarkRow("extractTopK (k >= queue size, drain)", rest, secondsSince(start));
+    bool drainedAll = drained.size() == rest && batched.empty();
+    for (int handle : handles) {
+        drainedAll = drainedAll && !batched.contains(handle);
+    }
+    if (!drainedAll) {
+        cout << "Error: extractTopK with k >= queue size left patients queued!\n";
+    }
+}
+
+// Relaxed vs strict concurrent queue with every thread inserting and treating
+void benchmarkConcurrentQueue() {
+    const int PREFILL = 100000;
+    const int OPS_PER_THREAD = 200000;
+    const int threadCounts[] = {1, 2, 4, 8, 16, 32};
+
+    cout << "\n--- Concurrent queue: alternating insert/extract, " << PREFILL << " prefilled, "
+         << thread::hardware_concurrency() << " hardware threads ---\n";
+    for (int strict = 0; strict <= 1; strict++) {
+        for (int threads : threadCounts) {
+            ConcurrentERQueue<int> queue(strict, threads);
+            for (int i = 0; i < PREFILL; i++) {
+                queue.insert(i, i % 5 + 1);
+            }
+
+            atomic<bool> start(false);
+            vector<thread> workers;
+            for (int t = 0; t < threads; t++) {
+                workers.emplace_back([&, t]() {
+                    while (!start.load()) {
+                        this_thread::yield();
+                    }
+                    int item;
+                    for (int i = 0; i < OPS_PER_THREAD / 2; i++) {
+                        queue.insert(t, (t + i) % 5 + 1);
+                        queue.extract(item);
+                    }
+                });
+            }
+            auto begin = chrono::steady_clock::now();
+            start.store(true);
+            for (thread& worker : workers) {
+                worker.join();
+            }
+            string name = string(strict ? "Strict (single heap), " : "Relaxed MultiQueue, ") + to_string(threads) +
+                          (threads == 1 ? " thread" : " threads");
+            printBenchmarkRow(name, (long long)threads * OPS_PER_THREAD, secondsSince(begin));
+        }
+    }
+}
+
+// Ward consolidation: pairing heap meld vs re-inserting into the 4-ary heap.
+// 64 wards each run insert/extract traffic, then merge pairwise until one
+// queue is left.
+void benchmarkMergeableHeaps() {
+    const int WARDS = 64;
+    const int INITIAL = 20000;
+    const int OPS_PER_ROUND = 20000;
+
+    cout << "\n--- Ward consolidation: " << WARDS << " wards x " << INITIAL
+         << " patients, mixed insert/extract, pairwise merges ---\n";
+
+    {
+        mt19937 rng(11);
+        vector<unique_ptr<IndexedDaryHeap<4>>> wards;
+        for (int w = 0; w < WARDS; w++) {
+            wards.emplace_back(new IndexedDaryHeap<4>());
+        }
+        long long operations = 0;
+        double mergeSeconds = 0;
+        auto start = chrono::steady_clock::now();
+        for (auto& ward : wards) {
+            for (int i = 0; i < INITIAL; i++) {
+                ward->push("Patient", rng() % 1000);
+            }
+            operations += INITIAL;
+        }
+        while (true) {
+            for (auto& ward : wards) {
+                for (int i = 0; i < OPS_PER_ROUND; i++) {
+                    if (rng() % 2 || ward->empty()) {
+                        ward->push("Patient", rng() % 1000);
+                    } else {
+                        ward->pop();
+                    }
+                }
+                operations += OPS_PER_ROUND;
+            }
+            if (wards.size() == 1) {
+                break;
+            }
+            auto mergeStart = chrono::steady_clock::now();
+            vector<unique_ptr<IndexedDaryHeap<4>>> merged;
+            for (size_t w = 0; w < wards.size(); w += 2) {
+                IndexedDaryHeap<4>& other = *wards[w + 1];
+                for (size_t i = 0; i < other.size(); i++) {
+                    const Patient& patient = other.patient(other.handleAt(i));
+                    wards[w]->push(patient.name, patient.priority);
+                }
+                merged.push_back(std::move(wards[w]));
+                operations++;
+            }
+            wards = std::move(merged);
+            mergeSeconds += secondsSince(mergeStart);
+        }
+        printBenchmarkRow("Indexed 4-ary heap, merge by re-insert", operations, secondsSince(start));
+        cout << "  (" << fixed << setprecision(1) << mergeSeconds * 1000 << " ms spent merging)\n";
+    }
+    {
+        mt19937 rng(11);
+        vector<unique_ptr<PairingHeap<Patient>>> wards;
+        for (int w = 0; w < WARDS; w++) {
+            wards.emplace_back(new PairingHeap<Patient>());
+        }
+        long long operations = 0;
+        double mergeSeconds = 0;
+        auto start = chrono::steady_clock::now();
+        for (auto& ward : wards) {
+            for (int i = 0; i < INITIAL; i++) {
+                int priority = rng() % 1000;
+                ward->push(Patient("Patient", priority), priority);
+            }
+            operations += INITIAL;
+        }
+        while (true) {
+            for (auto& ward : wards) {
+                for (int i = 0; i < OPS_PER_ROUND; i++) {
+                    if (rng() % 2 || ward->empty()) {
+                        int priority = rng() % 1000;
+                        ward->push(Patient("Patient", priority), priority);
+                    } else {
+                        ward->pop();
+                    }
+                }
+                operations += OPS_PER_ROUND;
+            }
+            if (wards.size() == 1) {
+                break;
+            }
+            auto mergeStart = chrono::steady_clock::now();
+            vector<unique_ptr<PairingHeap<Patient>>> merged;
+            for (size_t w = 0; w < wards.size(); w += 2) {
+                wards[w]->meld(*wards[w + 1]);
+                merged.push_back(std::move(wards[w]));
+                operations++;
+            }
+            wards = std::move(merged);
+            mergeSeconds += secondsSince(mergeStart);
+        }
+        printBenchmarkRow("Pairing heap (pooled nodes), O(1) meld", operations, secondsSince(start));
+        cout << "  (" << fixed << setprecision(1) << mergeSeconds * 1000 << " ms spent merging)\n";
+    }
+}
+
+// Extract-min throughput of the heap layouts with 10M patients queued
+template <typename Heap>
+void benchmarkExtractAll(const string& name, const vector<int>& priorities) {
+    Heap heap;
+    for (int priority : priorities) {
+        heap.push("Patient", priority);
+    }
+    auto start = chrono::steady_clock::now();
+    while (!heap.empty()) {
+        heap.pop();
+    }
+    printBenchmarkRow(name, priorities.size(), secondsSince(start));
+}
+
+void benchmarkHeapLayouts() {
+    const int COUNT = 10000000;
+
+    mt19937 rng(5);
+    vector<int> priorities(COUNT);
+    for (int& p : priorities) {
+        p = rng() % (1 << 23);
+    }
+
+    cout << "\n--- Heap layouts: extract-min of " << COUNT << " queued patients ---\n";
+    benchmarkExtractAll<IndexedDaryHeap<4>>("Indexed 4-ary heap (AoS entries)", priorities);
+    benchmarkExtractAll<AlignedKeyHeap<false>>("SoA 8-ary heap, cache-aligned, scalar", priorities);
+    if (AlignedKeyHeap<true>::simdEnabled()) {
+        benchmarkExtractAll<AlignedKeyHeap<true>>("SoA 8-ary heap, cache-aligned, AVX2", priorities);
+    } else {
+        cout << "(compile with -mavx2 or -march=native to include the AVX2 variant)\n";
+    }
+}
+
+// Run all priority queue benchmarks
+void runBenchmarks() {
+    cout << "\n===== Priority Queue Benchmarks =====\n";
+    benchmarkBucketQueue();
+    benchmarkBatchOperations();
+    benchmarkConcurrentQueue();
+    benchmarkMergeableHeaps();
+    benchmarkHeapLayouts();
+    cout << "=====================================\n\n";
+}
+
 // Display menu
 void displayMenu() {
     cout << "\n===== ER Priority Queue Menu =====\n";
     cout << "1. Add new patient\n";
     cout << "2. Treat highest priority patient\n";
     cout << "3. Display all patients\n";
-    cout << "4. Exit\n";
-    cout << "Enter your choice (1-4): ";
+    cout << "4. Update patient priority\n";
+    cout << "5. Remove patient (left the ER)\n";
+    cout << "6. Mass-casualty intake (add several patients)\n";
+    cout << "7. Treat several patients\n";
+    cout << "8. Advance clock (aging)\n";
+    cout << "9. Show wait-time percentiles\n";
+    cout << "10. Set aging threshold\n";
+    cout << "11. Run performance benchmarks\n";
+    cout << "12. Exit\n";
+    cout << "Enter your choice (1-12): ";
 }
 
 void clearInputBuffer() {
@@ -129,7 +1496,7 @@ void clearInputBuffer() {
 
 int main() {
     ERPriority er;
-    int choice, priority;
+    int choice, priority, id;
     string name;
     bool running = true;
 
@@ -170,12 +1537,104 @@ int main() {
                 break;
                 
             case 4:
+                cout << "Enter patient ID: ";
+                if (!(cin >> id)) {
+                    cout << "Invalid ID. Please enter a number.\n";
+                    clearInputBuffer();
+                    break;
+                }
+                cout << "Enter new priority level (1-5): ";
+                if (!(cin >> priority) || priority < 1 || priority > 5) {
+                    cout << "Invalid priority. Please enter a number between 1 and 5.\n";
+                    clearInputBuffer();
+                    break;
+                }
+                clearInputBuffer();
+                er.updatePriority(id, priority);
+                break;
+
+            case 5:
+                cout << "Enter patient ID: ";
+                if (!(cin >> id)) {
+                    cout << "Invalid ID. Please enter a number.\n";
+                    clearInputBuffer();
+                    break;
+                }
+                clearInputBuffer();
+                er.removePatient(id);
+                break;
+
+            case 6: {
+                vector<Patient> arrivals;
+                string line;
+                cout << "Enter one patient per line as \"name, priority\" (blank line to finish):\n";
+                while (getline(cin, line) && !line.empty()) {
+                    size_t comma = line.rfind(',');
+                    istringstream level(comma == string::npos ? "" : line.substr(comma + 1));
+                    if (!(level >> priority) || priority < 1 || priority > 5) {
+                        cout << "Invalid line, expected \"name, priority\" with priority 1-5. Skipped.\n";
+                        continue;
+                    }
+                    arrivals.push_back(Patient(line.substr(0, comma), priority));
+                }
+                er.insertBatch(arrivals);
+                break;
+            }
+
+            case 7:
+                cout << "Enter number of patients to treat: ";
+                if (!(cin >> id) || id < 1) {
+                    cout << "Invalid number. Please enter a positive number.\n";
+                    clearInputBuffer();
+                    break;
+                }
+                clearInputBuffer();
+                er.extractTopK(id);
+                break;
+
+            case 8:
+                cout << "Enter minutes to advance: ";
+                if (!(cin >> id) || id < 1) {
+                    cout << "Invalid number. Please enter a positive number.\n";
+                    clearInputBuffer();
+                    break;
+                }
+                clearInputBuffer();
+                er.advanceClock(id);
+                break;
+
+            case 9:
+                er.displayWaitTimes();
+                break;
+
+            case 10:
+                cout << "Enter priority level (2-5): ";
+                if (!(cin >> priority)) {
+                    cout << "Invalid level. Please enter a number.\n";
+                    clearInputBuffer();
+                    break;
+                }
+                cout << "Enter minutes before promotion: ";
+                if (!(cin >> id)) {
+                    cout << "Invalid number. Please enter a number.\n";
+                    clearInputBuffer();
+                    break;
+                }
+                clearInputBuffer();
+                er.setAgingThreshold(priority, id);
+                break;
+
+            case 11:
+                runBenchmarks();
+                break;
+
+            case 12:
                 cout << "Exiting ER Priority System. Goodbye!\n";
                 running = false;
                 break;
                 
             default:
-                cout << "Invalid choice. Please enter a number between 1 and 4.\n";
+                cout << "Invalid choice. Please enter a number between 1 and 12.\n";
         }
     }
 
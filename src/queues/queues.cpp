@@ -1,90 +1,1207 @@
 #include <iostream>
 #include <string>
 #include <limits>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <chrono>
+#include <iomanip>
+#include <cstdlib>
+#include <new>
+#include <condition_variable>
+#include <algorithm>
+#include <ctime>
+#include <random>
+#include <cstdint>
+#if defined(__cpp_impl_coroutine) && __has_include(<coroutine>)
+#include <coroutine>
+#define QUEUE_HAS_COROUTINES 1
+#endif
 
 using namespace std;
 
-// Node for the queue
+// Heap allocations made by the program, reported by the benchmarks
+atomic<long long> allocationCount(0);
+
+// Kept out of line: after inlining GCC sees malloc/free pairs against
+// new/delete and reports a false -Wmismatched-new-delete
+#if defined(__GNUC__) || defined(__clang__)
+#define COUNTER_NOINLINE __attribute__((noinline))
+#else
+#define COUNTER_NOINLINE
+#endif
+
+COUNTER_NOINLINE void* operator new(size_t size) {
+    allocationCount.fetch_add(1, memory_order_relaxed);
+    if (void* memory = malloc(size ? size : 1)) {
+        return memory;
+    }
+    throw bad_alloc();
+}
+
+COUNTER_NOINLINE void operator delete(void* memory) noexcept {
+    free(memory);
+}
+
+COUNTER_NOINLINE void operator delete(void* memory, size_t) noexcept {
+    free(memory);
+}
+
+// Patient waiting in the queue
 struct Patient {
     string name;
-    Patient* next;
-    Patient(string n) : name(n), next(nullptr) {}
+    Patient() {}
+    Patient(string n) : name(n) {}
+};
+
+// Unbounded FIFO queue made of linked fixed-size segments.
+// Items are stored in arrays of SEGMENT_SIZE, so enqueue and dequeue only
+// allocate when a segment fills up, and a walk over the queue follows one
+// pointer per segment instead of one per item. Drained segments go to a
+// small free list and are reused, so a queue in steady state allocates
+// nothing.
+template <typename T>
+class SegmentedQueue {
+private:
+    static const int SEGMENT_SIZE = 512;
+    static const int MAX_FREE_SEGMENTS = 4;
+
+    struct Segment {
+        T items[SEGMENT_SIZE];
+        Segment* next;
+    };
+
+    Segment* head;     // Segment holding the front item
+    int headIndex;
+    Segment* tail;     // Segment receiving the next item
+    int tailIndex;
+    Segment* freeSegments;
+    int freeCount;
+    size_t count;
+
+    Segment* allocateSegment() {
+        Segment* segment;
+        if (freeSegments) {
+            segment = freeSegments;
+            freeSegments = segment->next;
+            freeCount--;
+        } else {
+            segment = new Segment();
+        }
+        segment->next = nullptr;
+        return segment;
+    }
+
+    void releaseSegment(Segment* segment) {
+        if (freeCount == MAX_FREE_SEGMENTS) {
+            delete segment;
+            return;
+        }
+        segment->next = freeSegments;
+        freeSegments = segment;
+        freeCount++;
+    }
+
+public:
+    SegmentedQueue() : head(nullptr), headIndex(0), tail(nullptr), tailIndex(0),
+                       freeSegments(nullptr), freeCount(0), count(0) {}
+
+    ~SegmentedQueue() {
+        while (head) {
+            Segment* next = head->next;
+            delete head;
+            head = next;
+        }
+        while (freeSegments) {
+            Segment* next = freeSegments->next;
+            delete freeSegments;
+            freeSegments = next;
+        }
+    }
+
+    SegmentedQueue(const SegmentedQueue&) = delete;
+    SegmentedQueue& operator=(const SegmentedQueue&) = delete;
+
+    bool empty() const { return count == 0; }
+    size_t size() const { return count; }
+    T& front() { return head->items[headIndex]; }
+
+    void push(const T& item) {
+        if (!tail) {
+            head = tail = allocateSegment();
+            headIndex = tailIndex = 0;
+        } else if (tailIndex == SEGMENT_SIZE) {
+            tail->next = allocateSegment();
+            tail = tail->next;
+            tailIndex = 0;
+        }
+        tail->items[tailIndex++] = item;
+        count++;
+    }
+
+    // Remove and return the front item; the queue must not be empty
+    T pop() {
+        T item = std::move(head->items[headIndex++]);
+        count--;
+        if (count == 0) {
+            // Keep the segment and start over at its beginning
+            headIndex = tailIndex = 0;
+        } else if (headIndex == SEGMENT_SIZE) {
+            Segment* drained = head;
+            head = head->next;
+            headIndex = 0;
+            releaseSegment(drained);
+        }
+        return item;
+    }
+
+    // Call visit(item) for each item from front to rear
+    template <typename Visit>
+    void forEach(Visit visit) const {
+        for (Segment* segment = head; segment; segment = segment->next) {
+            int first = segment == head ? headIndex : 0;
+            int last = segment == tail ? tailIndex : SEGMENT_SIZE;
+            for (int i = first; i < last; i++) {
+                visit(segment->items[i]);
+            }
+        }
+    }
 };
 
 // Queue for hospital patients
 class HospitalQueue {
 private:
-    Patient* front;
-    Patient* rear;
+    SegmentedQueue<Patient> patients;
 
 public:
-    HospitalQueue() : front(nullptr), rear(nullptr) {}
-
     // Add patient to queue
     void enqueue(string name) {
-        Patient* newPatient = new Patient(name);
-        if (!rear) {
-            front = rear = newPatient;
-        } else {
-            rear->next = newPatient;
-            rear = newPatient;
-        }
+        patients.push(Patient(name));
         cout << "Added patient: " << name << "\n";
     }
 
     // Remove patient from queue
     void dequeue() {
-        if (!front) {
+        if (patients.empty()) {
             cout << "Queue is empty!\n";
             return;
         }
-        Patient* temp = front;
-        cout << "Treating patient: " << temp->name << "\n";
-        front = front->next;
-        if (!front) {
-            rear = nullptr;
-        }
-        delete temp;
+        Patient patient = patients.pop();
+        cout << "Treating patient: " << patient.name << "\n";
     }
 
     // Display queue
     void displayQueue() {
-        if (!front) {
+        if (patients.empty()) {
             cout << "Queue is empty!\n";
             return;
         }
         cout << "\n===== Patient Queue =====\n";
-        Patient* current = front;
         int position = 1;
-        while (current) {
-            cout << position++ << ". " << current->name;
-            if (current == front) {
+        patients.forEach([&](const Patient& patient) {
+            cout << position << ". " << patient.name;
+            if (position == 1) {
                 cout << " (next to be treated)";
             }
             cout << "\n";
-            current = current->next;
-        }
+            position++;
+        });
         cout << "========================\n\n";
     }
+};
+
+// Round a ring capacity up to a power of two so indices wrap with a mask
+inline size_t roundUpToPowerOfTwo(size_t n) {
+    size_t capacity = 2;
+    while (capacity < n) {
+        capacity <<= 1;
+    }
+    return capacity;
+}
+
+// Bounded wait-free queue for one producer thread (a registration kiosk) and
+// one consumer thread (a doctor station). The read and write indices sit on
+// separate cache lines, and each side keeps a private copy of the other's
+// index, refreshing it only when the ring looks full or empty, so the two
+// threads rarely touch the same cache line.
+template <typename T>
+class SPSCRingQueue {
+private:
+    static const size_t CACHE_LINE = 64;
+
+    alignas(CACHE_LINE) atomic<size_t> head;  // Next slot to read, written by the consumer
+    size_t cachedTail;                        // Consumer's copy of tail
+    alignas(CACHE_LINE) atomic<size_t> tail;  // Next slot to write, written by the producer
+    size_t cachedHead;                        // Producer's copy of head
+    alignas(CACHE_LINE) size_t mask;
+    unique_ptr<T[]> buffer;
+
+public:
+    explicit SPSCRingQueue(size_t capacity)
+        : head(0), cachedTail(0), tail(0), cachedHead(0),
+          mask(roundUpToPowerOfTwo(capacity) - 1), buffer(new T[mask + 1]) {}
+
+    size_t capacity() const { return mask + 1; }
+
+    // Producer side: false if the ring is full
+    bool tryEnqueue(const T& item) {
+        size_t position = tail.load(memory_order_relaxed);
+        if (position - cachedHead > mask) {
+            cachedHead = head.load(memory_order_acquire);
+            if (position - cachedHead > mask) {
+                return false;
+            }
+        }
+        buffer[position & mask] = item;
+        tail.store(position + 1, memory_order_release);
+        return true;
+    }
+
+    // Consumer side: false if the ring is empty
+    bool tryDequeue(T& item) {
+        size_t position = head.load(memory_order_relaxed);
+        if (position == cachedTail) {
+            cachedTail = tail.load(memory_order_acquire);
+            if (position == cachedTail) {
+                return false;
+            }
+        }
+        item = std::move(buffer[position & mask]);
+        head.store(position + 1, memory_order_release);
+        return true;
+    }
+
+    // Producer side: enqueue up to count items, publishing them with one
+    // store; returns how many fit
+    size_t enqueueN(const T* items, size_t count) {
+        size_t position = tail.load(memory_order_relaxed);
+        size_t space = mask + 1 - (position - cachedHead);
+        if (space < count) {
+            cachedHead = head.load(memory_order_acquire);
+            space = mask + 1 - (position - cachedHead);
+        }
+        count = min(count, space);
+        for (size_t i = 0; i < count; i++) {
+            buffer[(position + i) & mask] = items[i];
+        }
+        tail.store(position + count, memory_order_release);
+        return count;
+    }
+
+    // Consumer side: dequeue up to maxCount items; returns how many were taken
+    size_t dequeueN(T* items, size_t maxCount) {
+        size_t position = head.load(memory_order_relaxed);
+        size_t available = cachedTail - position;
+        if (available < maxCount) {
+            cachedTail = tail.load(memory_order_acquire);
+            available = cachedTail - position;
+        }
+        size_t count = min(maxCount, available);
+        for (size_t i = 0; i < count; i++) {
+            items[i] = std::move(buffer[(position + i) & mask]);
+        }
+        head.store(position + count, memory_order_release);
+        return count;
+    }
+};
+
+// Bounded lock-free queue for any number of kiosks and doctor stations
+// (Vyukov's MPMC ring). Each cell carries a sequence number that says whether
+// it is ready to be written (sequence == position) or read
+// (sequence == position + 1). Threads claim positions with a CAS on the
+// shared write or read index, then fill or drain their cell and publish it
+// by bumping its sequence.
+template <typename T>
+class MPMCRingQueue {
+private:
+    static const size_t CACHE_LINE = 64;
+
+    struct Cell {
+        atomic<size_t> sequence;
+        T data;
+    };
+
+    size_t mask;
+    unique_ptr<Cell[]> cells;
+    alignas(CACHE_LINE) atomic<size_t> enqueuePosition;
+    alignas(CACHE_LINE) atomic<size_t> dequeuePosition;
+    char padding[CACHE_LINE - sizeof(atomic<size_t>)];
+
+public:
+    explicit MPMCRingQueue(size_t capacity)
+        : mask(roundUpToPowerOfTwo(capacity) - 1), cells(new Cell[mask + 1]),
+          enqueuePosition(0), dequeuePosition(0) {
+        for (size_t i = 0; i <= mask; i++) {
+            cells[i].sequence.store(i, memory_order_relaxed);
+        }
+    }
+
+    size_t capacity() const { return mask + 1; }
+
+    // False if the ring is full
+    bool tryEnqueue(const T& item) {
+        size_t position = enqueuePosition.load(memory_order_relaxed);
+        while (true) {
+            Cell& cell = cells[position & mask];
+            size_t sequence = cell.sequence.load(memory_order_acquire);
+            if (sequence == position) {
+                if (enqueuePosition.compare_exchange_weak(position, position + 1, memory_order_relaxed)) {
+                    cell.data = item;
+                    cell.sequence.store(position + 1, memory_order_release);
+                    return true;
+                }
+            } else if (sequence < position) {
+                return false;  // Cell still holds an unread item from the previous lap
+            } else {
+                position = enqueuePosition.load(memory_order_relaxed);
+            }
+        }
+    }
+
+    // False if the ring is empty
+    bool tryDequeue(T& item) {
+        size_t position = dequeuePosition.load(memory_order_relaxed);
+        while (true) {
+            Cell& cell = cells[position & mask];
+            size_t sequence = cell.sequence.load(memory_order_acquire);
+            if (sequence == position + 1) {
+                if (dequeuePosition.compare_exchange_weak(position, position + 1, memory_order_relaxed)) {
+                    item = std::move(cell.data);
+                    cell.sequence.store(position + mask + 1, memory_order_release);
+                    return true;
+                }
+            } else if (sequence < position + 1) {
+                return false;
+            } else {
+                position = dequeuePosition.load(memory_order_relaxed);
+            }
+        }
+    }
+
+    // Enqueue up to count items with a single CAS: count the free cells in a
+    // row from the write index, then claim them all at once. Returns how
+    // many were enqueued.
+    size_t enqueueN(const T* items, size_t count) {
+        size_t position = enqueuePosition.load(memory_order_relaxed);
+        while (true) {
+            size_t free = 0;
+            while (free < count && cells[(position + free) & mask].sequence.load(memory_order_acquire) == position + free) {
+                free++;
+            }
+            if (free == 0) {
+                size_t sequence = cells[position & mask].sequence.load(memory_order_acquire);
+                if (sequence < position) {
+                    return 0;
+                }
+                position = enqueuePosition.load(memory_order_relaxed);
+                continue;
+            }
+            if (enqueuePosition.compare_exchange_weak(position, position + free, memory_order_relaxed)) {
+                for (size_t i = 0; i < free; i++) {
+                    Cell& cell = cells[(position + i) & mask];
+                    cell.data = items[i];
+                    cell.sequence.store(position + i + 1, memory_order_release);
+                }
+                return free;
+            }
+        }
+    }
+
+    // Dequeue up to maxCount items with a single CAS; returns how many were taken
+    size_t dequeueN(T* items, size_t maxCount) {
+        size_t position = dequeuePosition.load(memory_order_relaxed);
+        while (true) {
+            size_t ready = 0;
+            while (ready < maxCount &&
+                   cells[(position + ready) & mask].sequence.load(memory_order_acquire) == position + ready + 1) {
+                ready++;
+            }
+            if (ready == 0) {
+                size_t sequence = cells[position & mask].sequence.load(memory_order_acquire);
+                if (sequence < position + 1) {
+                    return 0;
+                }
+                position = dequeuePosition.load(memory_order_relaxed);
+                continue;
+            }
+            if (dequeuePosition.compare_exchange_weak(position, position + ready, memory_order_relaxed)) {
+                for (size_t i = 0; i < ready; i++) {
+                    Cell& cell = cells[(position + i) & mask];
+                    items[i] = std::move(cell.data);
+                    cell.sequence.store(position + i + mask + 1, memory_order_release);
+                }
+                return ready;
+            }
+        }
+    }
+};
+
+// Thread-safe unbounded queue whose consumers can wait for work.
+// waitDequeue spins briefly, polling an atomic item count, in case a patient
+// arrives within a few microseconds, then parks on a condition variable
+// (a futex on Linux) so an idle doctor station uses no CPU. Producers only
+// signal when someone is parked. With C++20, co_await next() suspends a
+// coroutine instead of a thread; it is resumed on the enqueuing thread with
+// the patient handed over directly.
+template <typename T>
+class BlockingQueue {
+private:
+    SegmentedQueue<T> items;
+    mutex lock;
+    condition_variable ready;
+    atomic<size_t> count;
+    int sleepers;  // Threads parked in waitDequeue, guarded by lock
+    int spinLimit;
+
+#ifdef QUEUE_HAS_COROUTINES
+public:
+    class NextAwaiter {
+    private:
+        BlockingQueue& queue;
+        T item;
+        coroutine_handle<> handle;
+        friend class BlockingQueue;
+
+    public:
+        explicit NextAwaiter(BlockingQueue& q) : queue(q) {}
+        bool await_ready() { return queue.tryDequeue(item); }
+        bool await_suspend(coroutine_handle<> h) {
+            handle = h;
+            lock_guard<mutex> guard(queue.lock);
+            if (!queue.items.empty()) {
+                item = queue.items.pop();
+                queue.count.fetch_sub(1, memory_order_relaxed);
+                return false;
+            }
+            queue.waiters.push(this);
+            return true;
+        }
+        T await_resume() { return std::move(item); }
+    };
+
+private:
+    SegmentedQueue<NextAwaiter*> waiters;  // Suspended coroutines, FIFO, guarded by lock
+#endif
+
+public:
+    explicit BlockingQueue(int spins = 1000) : count(0), sleepers(0), spinLimit(spins) {}
+
+    void enqueue(const T& item) {
+        unique_lock<mutex> guard(lock);
+#ifdef QUEUE_HAS_COROUTINES
+        if (!waiters.empty()) {
+            NextAwaiter* waiter = waiters.pop();
+            waiter->item = item;
+            guard.unlock();
+            waiter->handle.resume();
+            return;
+        }
+#endif
+        items.push(item);
+        count.fetch_add(1, memory_order_release);
+        bool wake = sleepers > 0;
+        guard.unlock();
+        if (wake) {
+            ready.notify_one();
+        }
+    }
+
+    bool tryDequeue(T& item) {
+        if (count.load(memory_order_acquire) == 0) {
+            return false;
+        }
+        lock_guard<mutex> guard(lock);
+        if (items.empty()) {
+            return false;
+        }
+        item = items.pop();
+        count.fetch_sub(1, memory_order_relaxed);
+        return true;
+    }
+
+    // Wait up to timeout for an item; false if none arrived in time
+    template <typename Duration>
+    bool waitDequeue(T& item, Duration timeout) {
+        auto deadline = chrono::steady_clock::now() + timeout;
+        for (int spin = 0; spin < spinLimit; spin++) {
+            if (tryDequeue(item)) {
+                return true;
+            }
+            this_thread::yield();
+        }
+        unique_lock<mutex> guard(lock);
+        sleepers++;
+        bool arrived = ready.wait_until(guard, deadline, [this]() { return !items.empty(); });
+        sleepers--;
+        if (!arrived) {
+            return false;
+        }
+        item = items.pop();
+        count.fetch_sub(1, memory_order_relaxed);
+        return true;
+    }
+
+#ifdef QUEUE_HAS_COROUTINES
+    // Awaitable for co_await queue.next()
+    NextAwaiter next() { return NextAwaiter(*this); }
+#endif
+};
+
+#ifdef QUEUE_HAS_COROUTINES
+// Fire-and-forget coroutine type for doctor stations
+struct StationTask {
+    struct promise_type {
+        StationTask get_return_object() { return {}; }
+        suspend_never initial_suspend() noexcept { return {}; }
+        suspend_never final_suspend() noexcept { return {}; }
+        void return_void() {}
+        void unhandled_exception() { terminate(); }
+    };
+};
+#endif
+
+// Chase-Lev work-stealing deque. The owner pushes at the bottom and any
+// thread steals from the top with a CAS. The ring grows when full; replaced
+// rings are kept until the deque is destroyed, since a thief may still be
+// reading one. T must be trivially copyable.
+template <typename T>
+class WorkStealingDeque {
+private:
+    static const size_t CACHE_LINE = 64;
+
+    struct Ring {
+        int64_t mask;
+        unique_ptr<atomic<T>[]> slots;
+        explicit Ring(int64_t capacity) : mask(capacity - 1), slots(new atomic<T>[capacity]) {}
+        T get(int64_t index) const { return slots[index & mask].load(memory_order_relaxed); }
+        void put(int64_t index, T item) { slots[index & mask].store(item, memory_order_relaxed); }
+    };
+
+    alignas(CACHE_LINE) atomic<int64_t> top;
+    alignas(CACHE_LINE) atomic<int64_t> bottom;
+    atomic<Ring*> ring;
+    vector<unique_ptr<Ring>> rings;  // Current and replaced rings, touched by the owner only
+
+public:
+    explicit WorkStealingDeque(int64_t capacity = 1024) : top(0), bottom(0) {
+        rings.emplace_back(new Ring(roundUpToPowerOfTwo(capacity)));
+        ring.store(rings.back().get(), memory_order_relaxed);
+    }
+
+    // Owner only
+    void push(T item) {
+        int64_t b = bottom.load(memory_order_relaxed);
+        int64_t t = top.load(memory_order_acquire);
+        Ring* current = ring.load(memory_order_relaxed);
+        if (b - t > current->mask) {
+            Ring* larger = new Ring(2 * (current->mask + 1));
+            for (int64_t i = t; i < b; i++) {
+                larger->put(i, current->get(i));
+            }
+            rings.emplace_back(larger);
+            ring.store(larger, memory_order_release);
+            current = larger;
+        }
+        current->put(b, item);
+        atomic_thread_fence(memory_order_release);
+        bottom.store(b + 1, memory_order_relaxed);
+    }
 
-    // Destructor to free memory
-    ~HospitalQueue() {
+    // Any thread: take the oldest item; false if empty or another thief won
+    bool steal(T& item) {
+        int64_t t = top.load(memory_order_acquire);
+        atomic_thread_fence(memory_order_seq_cst);
+        int64_t b = bottom.load(memory_order_acquire);
+        if (t >= b) {
+            return false;
+        }
+        T value = ring.load(memory_order_acquire)->get(t);
+        if (!top.compare_exchange_strong(t, t + 1, memory_order_seq_cst, memory_order_relaxed)) {
+            return false;
+        }
+        item = value;
+        return true;
+    }
+
+    bool empty() const {
+        return top.load(memory_order_relaxed) >= bottom.load(memory_order_relaxed);
+    }
+};
+
+// Patient routed by the dispatcher
+struct PatientTicket {
+    int id;
+    int department;
+};
+
+// Multi-queue dispatcher with one work-stealing deque per doctor station.
+// The dispatcher thread owns every deque and pushes each patient to a
+// station of the patient's department (round-robin within the department).
+// Stations take work from the top of the deques, so each station serves its
+// own patients in arrival order. An idle station first helps stations of its
+// own department, and after affinityRounds empty rounds also helps other
+// departments.
+class StationDispatcher {
+private:
+    int stationCount;
+    int affinityRounds;
+    vector<unique_ptr<WorkStealingDeque<PatientTicket>>> deques;
+    vector<int> stationDepartment;
+    vector<vector<int>> departmentStations;
+    vector<size_t> nextInDepartment;
+
+public:
+    // Counts of patients taken from the station's own deque, from another
+    // station of the same department, and from another department
+    atomic<long long> ownTaken, departmentSteals, crossSteals;
+
+    StationDispatcher(int stations, int departments, int affinity)
+        : stationCount(stations), affinityRounds(affinity), departmentStations(departments),
+          nextInDepartment(departments, 0), ownTaken(0), departmentSteals(0), crossSteals(0) {
+        for (int station = 0; station < stations; station++) {
+            deques.emplace_back(new WorkStealingDeque<PatientTicket>());
+            stationDepartment.push_back(station % departments);
+            departmentStations[station % departments].push_back(station);
+        }
+    }
+
+    // Dispatcher thread only
+    void dispatch(const PatientTicket& ticket) {
+        const vector<int>& stations = departmentStations[ticket.department];
+        int station;
+        if (stations.empty()) {
+            station = ticket.id % stationCount;  // Department without its own station
+        } else {
+            station = stations[nextInDepartment[ticket.department]++ % stations.size()];
+        }
+        deques[station]->push(ticket);
+    }
+
+    // Next patient for a station; idleRounds is how many calls in a row
+    // came back empty for this station
+    bool take(int station, PatientTicket& ticket, int idleRounds) {
+        if (deques[station]->steal(ticket)) {
+            ownTaken.fetch_add(1, memory_order_relaxed);
+            return true;
+        }
+        int department = stationDepartment[station];
+        const vector<int>& colleagues = departmentStations[department];
+        for (size_t i = 0; i < colleagues.size(); i++) {
+            int victim = colleagues[(station + i) % colleagues.size()];
+            if (victim != station && deques[victim]->steal(ticket)) {
+                departmentSteals.fetch_add(1, memory_order_relaxed);
+                return true;
+            }
+        }
+        if (idleRounds < affinityRounds) {
+            return false;
+        }
+        for (int i = 1; i < stationCount; i++) {
+            int victim = (station + i) % stationCount;
+            if (stationDepartment[victim] != department && deques[victim]->steal(ticket)) {
+                crossSteals.fetch_add(1, memory_order_relaxed);
+                return true;
+            }
+        }
+        return false;
+    }
+};
+
+// Baseline for the benchmarks: the original linked design of HospitalQueue,
+// one node allocated per patient
+template <typename T>
+class LinkedQueue {
+private:
+    struct Node {
+        T data;
+        Node* next;
+    };
+    Node* front;
+    Node* rear;
+
+public:
+    LinkedQueue() : front(nullptr), rear(nullptr) {}
+    ~LinkedQueue() {
+        while (front) {
+            Node* temp = front;
+            front = front->next;
+            delete temp;
+        }
+    }
+
+    bool empty() const { return front == nullptr; }
+
+    void push(const T& item) {
+        Node* node = new Node{item, nullptr};
+        if (!rear) {
+            front = rear = node;
+        } else {
+            rear->next = node;
+            rear = node;
+        }
+    }
+
+    T pop() {
+        Node* node = front;
+        front = front->next;
+        if (!front) {
+            rear = nullptr;
+        }
+        T item = std::move(node->data);
+        delete node;
+        return item;
+    }
+
+    template <typename Visit>
+    void forEach(Visit visit) const {
+        for (Node* node = front; node; node = node->next) {
+            visit(node->data);
+        }
+    }
+};
+
+// The linked design made thread-safe with a mutex
+template <typename T>
+class LockedLinkedQueue {
+private:
+    struct Node {
+        T data;
+        Node* next;
+    };
+    Node* front;
+    Node* rear;
+    mutex lock;
+
+public:
+    LockedLinkedQueue() : front(nullptr), rear(nullptr) {}
+    ~LockedLinkedQueue() {
         while (front) {
-            Patient* temp = front;
+            Node* temp = front;
             front = front->next;
             delete temp;
         }
     }
+
+    bool tryEnqueue(const T& item) {
+        Node* node = new Node{item, nullptr};
+        lock_guard<mutex> guard(lock);
+        if (!rear) {
+            front = rear = node;
+        } else {
+            rear->next = node;
+            rear = node;
+        }
+        return true;
+    }
+
+    bool tryDequeue(T& item) {
+        Node* node;
+        {
+            lock_guard<mutex> guard(lock);
+            if (!front) {
+                return false;
+            }
+            node = front;
+            front = front->next;
+            if (!front) {
+                rear = nullptr;
+            }
+        }
+        item = node->data;
+        delete node;
+        return true;
+    }
 };
 
+// Seconds elapsed since a start time
+double secondsSince(chrono::steady_clock::time_point start) {
+    return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+void printBenchmarkRow(const string& name, int pairs, long long operations, double seconds) {
+    cout << left << setw(40) << name << right << setw(6) << pairs << fixed << setprecision(1) << setw(10)
+         << seconds * 1000 << " ms" << setprecision(2) << setw(10) << operations / seconds / 1e6 << setw(12)
+         << operations / seconds / 1e6 / pairs << "\n" << left;
+}
+
+// Each of pairs kiosks registers PER_PRODUCER patient IDs one at a time and
+// each of pairs doctor stations treats them. Operations count every enqueue
+// and every dequeue.
+template <typename Queue>
+double runSingleTransfers(Queue& queue, int pairs, int perProducer) {
+    atomic<long long> remaining(1LL * pairs * perProducer);
+    vector<thread> threads;
+    auto start = chrono::steady_clock::now();
+    for (int p = 0; p < pairs; p++) {
+        threads.emplace_back([&queue, perProducer, p]() {
+            for (int i = 0; i < perProducer; i++) {
+                while (!queue.tryEnqueue(p * perProducer + i)) {
+                    this_thread::yield();
+                }
+            }
+        });
+        threads.emplace_back([&queue, &remaining]() {
+            int patient;
+            while (remaining.load(memory_order_relaxed) > 0) {
+                if (queue.tryDequeue(patient)) {
+                    remaining.fetch_sub(1, memory_order_relaxed);
+                } else {
+                    this_thread::yield();
+                }
+            }
+        });
+    }
+    for (thread& t : threads) {
+        t.join();
+    }
+    return secondsSince(start);
+}
+
+// Same workload moving patients in groups of BATCH with enqueueN/dequeueN
+template <typename Queue>
+double runBatchTransfers(Queue& queue, int pairs, int perProducer) {
+    static const int BATCH = 32;
+    atomic<long long> remaining(1LL * pairs * perProducer);
+    vector<thread> threads;
+    auto start = chrono::steady_clock::now();
+    for (int p = 0; p < pairs; p++) {
+        threads.emplace_back([&queue, perProducer, p]() {
+            int batch[BATCH];
+            int sent = 0;
+            while (sent < perProducer) {
+                int count = min(BATCH, perProducer - sent);
+                for (int i = 0; i < count; i++) {
+                    batch[i] = p * perProducer + sent + i;
+                }
+                int done = 0;
+                while (done < count) {
+                    size_t added = queue.enqueueN(batch + done, count - done);
+                    if (added == 0) {
+                        this_thread::yield();
+                    }
+                    done += added;
+                }
+                sent += count;
+            }
+        });
+        threads.emplace_back([&queue, &remaining]() {
+            int batch[BATCH];
+            while (remaining.load(memory_order_relaxed) > 0) {
+                size_t taken = queue.dequeueN(batch, BATCH);
+                if (taken > 0) {
+                    remaining.fetch_sub(taken, memory_order_relaxed);
+                } else {
+                    this_thread::yield();
+                }
+            }
+        });
+    }
+    for (thread& t : threads) {
+        t.join();
+    }
+    return secondsSince(start);
+}
+
+// Single-threaded enqueue/dequeue throughput and heap allocations of the
+// segmented queue vs one node per patient
+template <typename Queue>
+void benchmarkSingleThreaded(const string& name) {
+    const int BURST = 2000000;
+    const int STEADY_SIZE = 100000;
+    const int STEADY_OPS = 10000000;
+    const int WALKS = 20;
+    Patient patient("Patient");
+
+    Queue queue;
+    long long allocations = allocationCount.load();
+    auto start = chrono::steady_clock::now();
+    for (int i = 0; i < BURST; i++) {
+        queue.push(patient);
+    }
+    while (!queue.empty()) {
+        queue.pop();
+    }
+    double seconds = secondsSince(start);
+    cout << left << setw(34) << name << setw(14) << "fill + drain" << right << fixed << setprecision(1) << setw(9)
+         << seconds * 1000 << " ms" << setprecision(2) << setw(9) << 2.0 * BURST / seconds / 1e6 << " Mops/sec"
+         << setw(10) << allocationCount.load() - allocations << " allocs\n";
+
+    for (int i = 0; i < STEADY_SIZE; i++) {
+        queue.push(patient);
+    }
+    allocations = allocationCount.load();
+    start = chrono::steady_clock::now();
+    for (int i = 0; i < STEADY_OPS; i++) {
+        queue.push(patient);
+        queue.pop();
+    }
+    seconds = secondsSince(start);
+    cout << left << setw(34) << name << setw(14) << "steady state" << right << setprecision(1) << setw(9)
+         << seconds * 1000 << " ms" << setprecision(2) << setw(9) << 2.0 * STEADY_OPS / seconds / 1e6 << " Mops/sec"
+         << setw(10) << allocationCount.load() - allocations << " allocs\n";
+
+    size_t visited = 0;
+    start = chrono::steady_clock::now();
+    for (int walk = 0; walk < WALKS; walk++) {
+        queue.forEach([&](const Patient& p) { visited += !p.name.empty(); });
+    }
+    seconds = secondsSince(start);
+    cout << left << setw(34) << name << setw(14) << "display walk" << right << setprecision(1) << setw(9)
+         << seconds * 1000 << " ms" << setprecision(2) << setw(9) << visited / seconds / 1e6
+         << " M patients/sec\n" << left;
+}
+
+// Kiosk -> doctor station throughput of the concurrent queue variants
+void benchmarkRingQueues() {
+    const int PER_PRODUCER = 2000000;
+    const size_t CAPACITY = 4096;
+    long long operations;
+
+    cout << "\n===== Queue Benchmarks (" << PER_PRODUCER << " patients per kiosk, ring capacity " << CAPACITY
+         << ") =====\n";
+    cout << left << setw(40) << "Queue" << right << setw(6) << "Pairs" << setw(13) << "Time" << setw(10)
+         << "Mops/sec" << setw(12) << "per pair" << "\n" << left;
+
+    operations = 2LL * PER_PRODUCER;
+    {
+        LockedLinkedQueue<int> queue;
+        printBenchmarkRow("Mutex + node per patient", 1, operations, runSingleTransfers(queue, 1, PER_PRODUCER));
+    }
+    {
+        SPSCRingQueue<int> queue(CAPACITY);
+        printBenchmarkRow("SPSC ring", 1, operations, runSingleTransfers(queue, 1, PER_PRODUCER));
+    }
+    {
+        SPSCRingQueue<int> queue(CAPACITY);
+        printBenchmarkRow("SPSC ring, enqueueN/dequeueN", 1, operations, runBatchTransfers(queue, 1, PER_PRODUCER));
+    }
+
+    for (int pairs = 1; pairs <= 4; pairs *= 2) {
+        operations = 2LL * pairs * PER_PRODUCER;
+        {
+            LockedLinkedQueue<int> queue;
+            printBenchmarkRow("Mutex + node per patient", pairs, operations,
+                              runSingleTransfers(queue, pairs, PER_PRODUCER));
+        }
+        {
+            MPMCRingQueue<int> queue(CAPACITY);
+            printBenchmarkRow("MPMC ring", pairs, operations, runSingleTransfers(queue, pairs, PER_PRODUCER));
+        }
+        {
+            MPMCRingQueue<int> queue(CAPACITY);
+            printBenchmarkRow("MPMC ring, enqueueN/dequeueN", pairs, operations,
+                              runBatchTransfers(queue, pairs, PER_PRODUCER));
+        }
+    }
+    cout << "Threads available: " << thread::hardware_concurrency() << "\n";
+}
+
+// Microseconds from a steady_clock timestamp in nanoseconds until now
+double microsecondsSince(long long sentNanoseconds) {
+    long long now = chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now().time_since_epoch()).count();
+    return (now - sentNanoseconds) / 1000.0;
+}
+
+long long nanosecondsNow() {
+    return chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void printLatencyRow(const string& name, vector<double> latencies, double idleCpuMs) {
+    sort(latencies.begin(), latencies.end());
+    cout << left << setw(34) << name << right << fixed << setprecision(1) << setw(9)
+         << latencies[latencies.size() / 2] << setw(9) << latencies[latencies.size() * 99 / 100] << setw(10)
+         << latencies.back() << setw(14) << idleCpuMs << "\n" << left;
+}
+
+#ifdef QUEUE_HAS_COROUTINES
+StationTask doctorStation(BlockingQueue<long long>& queue, vector<double>& latencies, int patients) {
+    for (int i = 0; i < patients; i++) {
+        long long sent = co_await queue.next();
+        latencies.push_back(microsecondsSince(sent));
+    }
+}
+#endif
+
+// Wake-up latency of an idle doctor station: a kiosk sends one patient at a
+// time with pauses in between, stamped with the send time. Also reports the
+// CPU the process used while the station sat idle before the first patient.
+void benchmarkWakeupLatency() {
+    const int PATIENTS = 1000;
+    const auto GAP = chrono::microseconds(300);
+    const auto IDLE = chrono::milliseconds(200);
+
+    cout << "\n===== Doctor station wake-up (" << PATIENTS << " patients, one every " << GAP.count() << " us) =====\n";
+    cout << left << setw(34) << "Consumer" << right << setw(9) << "p50 us" << setw(9) << "p99 us" << setw(10)
+         << "max us" << setw(14) << "idle CPU ms" << "\n" << left;
+
+    for (int spins : {1000, 0}) {
+        BlockingQueue<long long> queue(spins);
+        vector<double> latencies;
+        thread station([&]() {
+            long long sent;
+            for (int i = 0; i < PATIENTS; i++) {
+                if (queue.waitDequeue(sent, chrono::seconds(5))) {
+                    latencies.push_back(microsecondsSince(sent));
+                }
+            }
+        });
+        clock_t idleStart = clock();
+        this_thread::sleep_for(IDLE);
+        double idleCpuMs = 1000.0 * (clock() - idleStart) / CLOCKS_PER_SEC;
+        for (int i = 0; i < PATIENTS; i++) {
+            queue.enqueue(nanosecondsNow());
+            this_thread::sleep_for(GAP);
+        }
+        station.join();
+        printLatencyRow(spins > 0 ? "waitDequeue, spin then park" : "waitDequeue, park at once", latencies,
+                        idleCpuMs);
+    }
+
+#ifdef QUEUE_HAS_COROUTINES
+    {
+        BlockingQueue<long long> queue;
+        vector<double> latencies;
+        doctorStation(queue, latencies, PATIENTS);
+        clock_t idleStart = clock();
+        this_thread::sleep_for(IDLE);
+        double idleCpuMs = 1000.0 * (clock() - idleStart) / CLOCKS_PER_SEC;
+        for (int i = 0; i < PATIENTS; i++) {
+            queue.enqueue(nanosecondsNow());
+            this_thread::sleep_for(GAP);
+        }
+        printLatencyRow("co_await next() (resumed inline)", latencies, idleCpuMs);
+    }
+#else
+    cout << "(compile with -std=c++20 to include the coroutine consumer)\n";
+#endif
+}
+
+// Simulated treatment: about a microsecond of work per patient
+unsigned treatPatient(const PatientTicket& ticket) {
+    unsigned state = ticket.id;
+    for (int i = 0; i < 300; i++) {
+        state = state * 1103515245 + 12345;
+    }
+    return state;
+}
+
+// Dispatcher scaling with station count: one thread dispatches patients of
+// 4 departments (skewed toward department 0) while the stations treat them,
+// compared with all stations sharing one locked FIFO
+void benchmarkDispatcher() {
+    const int PATIENTS = 400000;
+    const int DEPARTMENTS = 4;
+    const int AFFINITY_ROUNDS = 4;
+
+    mt19937 rng(3);
+    vector<PatientTicket> arrivals(PATIENTS);
+    for (int i = 0; i < PATIENTS; i++) {
+        int roll = rng() % 10;
+        arrivals[i] = {i, roll < 4 ? 0 : roll < 6 ? 1 : roll < 8 ? 2 : 3};
+    }
+
+    cout << "\n===== Station dispatcher (" << PATIENTS << " patients, " << DEPARTMENTS
+         << " departments, ~1 us treatment) =====\n";
+    cout << left << setw(28) << "Dispatch" << right << setw(9) << "Stations" << setw(12) << "Time" << setw(11)
+         << "M pat/sec" << setw(9) << "Own" << setw(10) << "Same dep" << setw(10) << "Cross" << "\n" << left;
+
+    for (int stations = 1; stations <= 16; stations *= 2) {
+        {
+            LockedLinkedQueue<PatientTicket> shared;
+            atomic<int> treated(0);
+            atomic<unsigned> checksum(0);
+            vector<thread> threads;
+            auto start = chrono::steady_clock::now();
+            for (int s = 0; s < stations; s++) {
+                threads.emplace_back([&]() {
+                    PatientTicket ticket;
+                    unsigned sum = 0;
+                    while (treated.load(memory_order_relaxed) < PATIENTS) {
+                        if (shared.tryDequeue(ticket)) {
+                            sum += treatPatient(ticket);
+                            treated.fetch_add(1, memory_order_relaxed);
+                        } else {
+                            this_thread::yield();
+                        }
+                    }
+                    checksum += sum;
+                });
+            }
+            for (const PatientTicket& ticket : arrivals) {
+                shared.tryEnqueue(ticket);
+            }
+            for (thread& t : threads) {
+                t.join();
+            }
+            double seconds = secondsSince(start);
+            cout << left << setw(28) << "Single shared FIFO" << right << setw(9) << stations << fixed
+                 << setprecision(1) << setw(9) << seconds * 1000 << " ms" << setprecision(2) << setw(11)
+                 << PATIENTS / seconds / 1e6 << "\n" << left;
+        }
+        {
+            StationDispatcher dispatcher(stations, DEPARTMENTS, AFFINITY_ROUNDS);
+            atomic<int> treated(0);
+            atomic<unsigned> checksum(0);
+            vector<thread> threads;
+            auto start = chrono::steady_clock::now();
+            for (int s = 0; s < stations; s++) {
+                threads.emplace_back([&, s]() {
+                    PatientTicket ticket;
+                    unsigned sum = 0;
+                    int idleRounds = 0;
+                    while (treated.load(memory_order_relaxed) < PATIENTS) {
+                        if (dispatcher.take(s, ticket, idleRounds)) {
+                            sum += treatPatient(ticket);
+                            treated.fetch_add(1, memory_order_relaxed);
+                            idleRounds = 0;
+                        } else {
+                            idleRounds++;
+                            this_thread::yield();
+                        }
+                    }
+                    checksum += sum;
+                });
+            }
+            for (const PatientTicket& ticket : arrivals) {
+                dispatcher.dispatch(ticket);
+            }
+            for (thread& t : threads) {
+                t.join();
+            }
+            double seconds = secondsSince(start);
+            cout << left << setw(28) << "Work-stealing per station" << right << setw(9) << stations << fixed
+                 << setprecision(1) << setw(9) << seconds * 1000 << " ms" << setprecision(2) << setw(11)
+                 << PATIENTS / seconds / 1e6 << setprecision(1) << setw(8)
+                 << 100.0 * dispatcher.ownTaken / PATIENTS << "%" << setw(9)
+                 << 100.0 * dispatcher.departmentSteals / PATIENTS << "%" << setw(9)
+                 << 100.0 * dispatcher.crossSteals / PATIENTS << "%\n" << left;
+        }
+    }
+    cout << "Threads available: " << thread::hardware_concurrency() << "\n";
+}
+
+// Run all queue benchmarks
+void runBenchmarks() {
+    cout << "\n===== Single-threaded HospitalQueue storage =====\n";
+    benchmarkSingleThreaded<LinkedQueue<Patient>>("Node per patient");
+    benchmarkSingleThreaded<SegmentedQueue<Patient>>("Segmented queue (512 per segment)");
+    benchmarkRingQueues();
+    benchmarkWakeupLatency();
+    benchmarkDispatcher();
+    cout << "=====================================\n";
+}
+
 // Display menu
 void displayMenu() {
     cout << "\n===== Hospital Queue Menu =====\n";
     cout << "1. Add new patient\n";
     cout << "2. Treat next patient\n";
     cout << "3. Display queue\n";
-    cout << "4. Exit\n";
-    cout << "Enter your choice (1-4): ";
+    cout << "4. Run performance benchmarks\n";
+    cout << "5. Exit\n";
+    cout << "Enter your choice (1-5): ";
 }
 
 void clearInputBuffer() {
@@ -125,13 +1242,17 @@ int main() {
                 queue.displayQueue();
                 break;
                 
-            case 4:  
+            case 4:
+                runBenchmarks();
+                break;
+
+            case 5:
                 cout << "Exiting Hospital Queue System. Goodbye!\n";
                 running = false;
                 break;
                 
             default:
-                cout << "Invalid choice. Please enter a number between 1 and 4.\n";
+                cout << "Invalid choice. Please enter a number between 1 and 5.\n";
         }
     }
 
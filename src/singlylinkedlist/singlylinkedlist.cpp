@@ -1,65 +1,671 @@
 #include <iostream>
 #include <string>
 #include <limits>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <iomanip>
+#include <cstdint>
+#include <unordered_map>
+#include <unordered_set>
+#include <cstdlib>
+#include <new>
 
 using namespace std;
 
-// Node for the singly linked list
+// Heap allocations made by the program, reported by the benchmarks
+long long allocationCount = 0;
+
+// Kept out of line: after inlining GCC sees malloc/free pairs against
+// new/delete and reports a false -Wmismatched-new-delete
+#if defined(__GNUC__) || defined(__clang__)
+#define COUNTER_NOINLINE __attribute__((noinline))
+#else
+#define COUNTER_NOINLINE
+#endif
+
+COUNTER_NOINLINE void* operator new(size_t size) {
+    allocationCount++;
+    if (void* memory = malloc(size ? size : 1)) {
+        return memory;
+    }
+    throw bad_alloc();
+}
+
+COUNTER_NOINLINE void* operator new(size_t size, const nothrow_t&) noexcept {
+    allocationCount++;
+    return malloc(size ? size : 1);
+}
+
+COUNTER_NOINLINE void operator delete(void* memory) noexcept {
+    free(memory);
+}
+
+COUNTER_NOINLINE void operator delete(void* memory, size_t) noexcept {
+    free(memory);
+}
+
+// Node for the singly linked list. Each song is also a node of an implicit
+// treap over the same songs in playlist order (left, right, parent, size of
+// its subtree and a random priority), which finds song #k in O(log n), and
+// remembers its slots in the title and artist hash indexes.
 struct Song {
     string title;
     string artist;
     Song* next;
-    Song(string t, string a) : title(t), artist(a), next(nullptr) {}
+
+    Song* left;
+    Song* right;
+    Song* parent;
+    size_t size;
+    uint32_t priority;
+
+    size_t titleSlot;
+    size_t artistSlot;
+
+    Song(string t, string a, uint32_t p = 0)
+        : title(t), artist(a), next(nullptr), left(nullptr), right(nullptr), parent(nullptr), size(1),
+          priority(p), titleSlot(0), artistSlot(0) {}
 };
 
-// Singly Linked List for playlist
+// Singly Linked List for playlist.
+// head and tail make appending O(1) on the list; the treap index costs
+// O(log n) per insert or removal and answers positional lookups in O(log n).
+// Hash indexes map each title and each artist to its songs, so finding a
+// song by title is O(1). Unlinking it still needs its predecessor, which a
+// singly linked list only gives through the treap, so removeSong is
+// O(log n); bulk removals unlink every match in one pass instead.
 class Playlist {
 private:
     Song* head;
+    Song* tail;
+    Song* root;  // Root of the treap index
+    mt19937 rng;
+    unordered_map<string, vector<Song*>> byTitle;
+    unordered_map<string, vector<Song*>> byArtist;
+
+    // Above this share of the playlist, one pass over the list beats
+    // removing songs one at a time
+    static const size_t BULK_RATIO = 32;
+
+    static size_t sizeOf(Song* node) { return node ? node->size : 0; }
+
+    // Recompute a node's subtree size and point its children back at it
+    static void update(Song* node) {
+        node->size = 1 + sizeOf(node->left) + sizeOf(node->right);
+        if (node->left) {
+            node->left->parent = node;
+        }
+        if (node->right) {
+            node->right->parent = node;
+        }
+    }
+
+    // Split the treap into its first count songs and the rest
+    static void split(Song* node, size_t count, Song*& first, Song*& rest) {
+        if (!node) {
+            first = rest = nullptr;
+            return;
+        }
+        if (sizeOf(node->left) < count) {
+            split(node->right, count - sizeOf(node->left) - 1, node->right, rest);
+            update(node);
+            first = node;
+        } else {
+            split(node->left, count, first, node->left);
+            update(node);
+            rest = node;
+        }
+    }
+
+    // Join two treaps, every song of a before every song of b
+    static Song* merge(Song* a, Song* b) {
+        if (!a) {
+            return b;
+        }
+        if (!b) {
+            return a;
+        }
+        if (a->priority > b->priority) {
+            a->right = merge(a->right, b);
+            update(a);
+            return a;
+        }
+        b->left = merge(a, b->left);
+        update(b);
+        return b;
+    }
+
+    void setRoot(Song* node) {
+        root = node;
+        if (root) {
+            root->parent = nullptr;
+        }
+    }
+
+    // Take a song out of the treap, keeping the order of the others
+    void detach(Song* song) {
+        Song* replacement = merge(song->left, song->right);
+        Song* parent = song->parent;
+        if (replacement) {
+            replacement->parent = parent;
+        }
+        if (!parent) {
+            root = replacement;
+        } else if (parent->left == song) {
+            parent->left = replacement;
+        } else {
+            parent->right = replacement;
+        }
+        for (; parent; parent = parent->parent) {
+            parent->size--;
+        }
+        song->left = song->right = song->parent = nullptr;
+        song->size = 1;
+    }
+
+    // Add a song to the slot list of its key
+    static void indexAdd(unordered_map<string, vector<Song*>>& index, const string& key, Song* song,
+                         size_t& slot) {
+        vector<Song*>& songs = index[key];
+        slot = songs.size();
+        songs.push_back(song);
+    }
+
+    // Remove a song from the slot list of its key, moving the last song of
+    // that list into its slot
+    static void indexRemove(unordered_map<string, vector<Song*>>& index, const string& key, size_t slot,
+                            size_t Song::*slotField) {
+        auto it = index.find(key);
+        vector<Song*>& songs = it->second;
+        songs[slot] = songs.back();
+        songs[slot]->*slotField = slot;
+        songs.pop_back();
+        if (songs.empty()) {
+            index.erase(it);
+        }
+    }
+
+    void addToIndexes(Song* song) {
+        indexAdd(byTitle, song->title, song, song->titleSlot);
+        indexAdd(byArtist, song->artist, song, song->artistSlot);
+    }
+
+    void removeFromIndexes(Song* song) {
+        indexRemove(byTitle, song->title, song->titleSlot, &Song::titleSlot);
+        indexRemove(byArtist, song->artist, song->artistSlot, &Song::artistSlot);
+    }
+
+    // Position of a song (0-based), walking up the treap in O(log n)
+    size_t indexOf(Song* song) const {
+        size_t index = sizeOf(song->left);
+        for (Song* node = song; node->parent; node = node->parent) {
+            if (node->parent->right == node) {
+                index += sizeOf(node->parent->left) + 1;
+            }
+        }
+        return index;
+    }
+
+    // Rebuild the treap from the list in O(n), keeping each song's priority.
+    // Songs are added left to right on the right spine; a node is final
+    // once a song with a higher priority pops it off the spine.
+    void rebuildIndex() {
+        vector<Song*> spine;
+        for (Song* song = head; song; song = song->next) {
+            Song* last = nullptr;
+            while (!spine.empty() && spine.back()->priority < song->priority) {
+                last = spine.back();
+                spine.pop_back();
+                update(last);
+            }
+            song->left = last;
+            song->right = nullptr;
+            if (!spine.empty()) {
+                spine.back()->right = song;
+            }
+            spine.push_back(song);
+        }
+        for (size_t i = spine.size(); i-- > 0;) {
+            update(spine[i]);
+        }
+        setRoot(spine.empty() ? nullptr : spine[0]);
+    }
+
+    // Remove and free one song, finding its predecessor through the treap
+    void removeNode(Song* song) {
+        size_t index = indexOf(song);
+        unlink(index > 0 ? songAt(index - 1) : nullptr, song);
+        removeFromIndexes(song);
+        delete song;
+    }
+
+    // Remove and free a set of songs: one at a time if they are few,
+    // otherwise in a single pass over the list
+    size_t removeNodes(const vector<Song*>& songs) {
+        if (songs.size() * BULK_RATIO < size()) {
+            for (Song* song : songs) {
+                removeNode(song);
+            }
+            return songs.size();
+        }
+        unordered_set<const Song*> doomed(songs.begin(), songs.end());
+        return removeIf([&doomed](const Song& song) { return doomed.count(&song) > 0; });
+    }
+
+    // Merge another playlist's index into one of ours. The bigger map is
+    // kept and the smaller one's entries are moved into it: keys only the
+    // smaller map has are spliced over as whole map nodes, and songs under
+    // keys both have are appended with new slots. O(smaller map).
+    static void mergeIndex(unordered_map<string, vector<Song*>>& into, unordered_map<string, vector<Song*>>& from,
+                           size_t Song::*slotField) {
+        if (from.size() > into.size()) {
+            into.swap(from);
+        }
+        into.merge(from);
+        for (auto& entry : from) {
+            vector<Song*>& songs = into.find(entry.first)->second;
+            for (Song* song : entry.second) {
+                song->*slotField = songs.size();
+                songs.push_back(song);
+            }
+        }
+        from.clear();
+    }
+
+    // Merge two sorted chains, taking from first on ties so the merge is
+    // stable when first holds the earlier songs
+    template <typename Less>
+    static Song* mergeChains(Song* first, Song* second, Less& less) {
+        Song* merged = nullptr;
+        Song** link = &merged;
+        while (first && second) {
+            if (less(*second, *first)) {
+                *link = second;
+                second = second->next;
+            } else {
+                *link = first;
+                first = first->next;
+            }
+            link = &(*link)->next;
+        }
+        *link = first ? first : second;
+        return merged;
+    }
+
+    // After the list was reordered: find the tail and rebuild the treap
+    void relinked() {
+        rebuildIndex();
+        tail = size() > 0 ? songAt(size() - 1) : nullptr;
+    }
+
+    // Unlink a song whose predecessor in the list is prev (null for head)
+    void unlink(Song* prev, Song* song) {
+        if (prev) {
+            prev->next = song->next;
+        } else {
+            head = song->next;
+        }
+        if (tail == song) {
+            tail = prev;
+        }
+        detach(song);
+    }
 
 public:
-    Playlist() : head(nullptr) {}
+    Playlist() : head(nullptr), tail(nullptr), root(nullptr), rng(2024) {}
+
+    size_t size() const { return sizeOf(root); }
+
+    // Song with this title and artist, or null
+    Song* findSong(const string& title, const string& artist) const {
+        auto it = byTitle.find(title);
+        if (it == byTitle.end()) {
+            return nullptr;
+        }
+        for (Song* song : it->second) {
+            if (song->artist == artist) {
+                return song;
+            }
+        }
+        return nullptr;
+    }
+
+    // Song number index (0-based) in O(log n), or null if out of range
+    Song* songAt(size_t index) const {
+        if (index >= size()) {
+            return nullptr;
+        }
+        Song* node = root;
+        while (true) {
+            size_t leftSize = sizeOf(node->left);
+            if (index < leftSize) {
+                node = node->left;
+            } else if (index == leftSize) {
+                return node;
+            } else {
+                index -= leftSize + 1;
+                node = node->right;
+            }
+        }
+    }
+
+    // Append a song without printing; O(1) on the list, O(log n) on the index
+    Song* append(const string& title, const string& artist) {
+        Song* newSong = new Song(title, artist, rng());
+        if (tail) {
+            tail->next = newSong;
+        } else {
+            head = newSong;
+        }
+        tail = newSong;
+        setRoot(merge(root, newSong));
+        addToIndexes(newSong);
+        return newSong;
+    }
+
+    // Insert a song so it becomes song number index (0-based), in O(log n)
+    Song* insertAt(size_t index, const string& title, const string& artist) {
+        if (index >= size()) {
+            return append(title, artist);
+        }
+        Song* newSong = new Song(title, artist, rng());
+        if (index == 0) {
+            newSong->next = head;
+            head = newSong;
+        } else {
+            Song* prev = songAt(index - 1);
+            newSong->next = prev->next;
+            prev->next = newSong;
+        }
+        Song* first;
+        Song* rest;
+        split(root, index, first, rest);
+        setRoot(merge(merge(first, newSong), rest));
+        addToIndexes(newSong);
+        return newSong;
+    }
 
     // Add song to the end of the playlist
     void addSong(string title, string artist) {
-        Song* newSong = new Song(title, artist);
-        if (!head) {
-            head = newSong;
+        if (findSong(title, artist)) {
+            cout << "Already in playlist: \"" << title << "\" by " << artist << "\n";
             return;
         }
-        Song* current = head;
-        while (current->next) {
-            current = current->next;
-        }
-        current->next = newSong;
+        append(title, artist);
         cout << "Added song: \"" << title << "\" by " << artist << "\n";
     }
 
+    // Insert song at a position (1 = first)
+    void insertSong(size_t position, string title, string artist) {
+        if (position == 0 || position > size() + 1) {
+            cout << "Position out of range! The playlist has " << size() << " songs.\n";
+            return;
+        }
+        if (findSong(title, artist)) {
+            cout << "Already in playlist: \"" << title << "\" by " << artist << "\n";
+            return;
+        }
+        insertAt(position - 1, title, artist);
+        cout << "Inserted song #" << position << ": \"" << title << "\" by " << artist << "\n";
+    }
+
+    // Play song by number (1 = first)
+    void playSong(size_t number) {
+        Song* song = number > 0 ? songAt(number - 1) : nullptr;
+        if (!song) {
+            cout << "No song #" << number << "! The playlist has " << size() << " songs.\n";
+            return;
+        }
+        cout << "Now playing #" << number << ": \"" << song->title << "\" by " << song->artist << "\n";
+    }
+
+    // Remove the first song with a title without printing; false if none
+    bool removeTitle(const string& title) {
+        auto it = byTitle.find(title);
+        if (it == byTitle.end()) {
+            return false;
+        }
+        Song* first = it->second[0];
+        if (it->second.size() > 1) {
+            size_t firstIndex = indexOf(first);
+            for (Song* song : it->second) {
+                size_t index = indexOf(song);
+                if (index < firstIndex) {
+                    first = song;
+                    firstIndex = index;
+                }
+            }
+        }
+        removeNode(first);
+        return true;
+    }
+
     // Remove song by title
     void removeSong(string title) {
         if (!head) {
             cout << "Playlist is empty!\n";
             return;
         }
-        if (head->title == title) {
-            Song* temp = head;
-            head = head->next;
-            delete temp;
+        if (removeTitle(title)) {
             cout << "Removed: \"" << title << "\"\n";
-            return;
+        } else {
+            cout << "Song not found!\n";
         }
+    }
+
+    // Remove every song matching a predicate in one pass over the list,
+    // then rebuild the treap in O(n); returns the number removed
+    template <typename Predicate>
+    size_t removeIf(Predicate matches) {
+        size_t removed = 0;
+        Song* prev = nullptr;
         Song* current = head;
-        while (current->next && current->next->title != title) {
-            current = current->next;
+        while (current) {
+            Song* next = current->next;
+            if (matches(*current)) {
+                if (prev) {
+                    prev->next = next;
+                } else {
+                    head = next;
+                }
+                removeFromIndexes(current);
+                delete current;
+                removed++;
+            } else {
+                prev = current;
+            }
+            current = next;
         }
-        if (current->next) {
-            Song* temp = current->next;
-            current->next = temp->next;
-            delete temp;
-            cout << "Removed: \"" << title << "\"\n";
+        tail = prev;
+        if (removed > 0) {
+            rebuildIndex();
+        }
+        return removed;
+    }
+
+    // Remove every song with one of these titles; returns the number removed
+    size_t removeAll(const vector<string>& titles) {
+        unordered_set<string> unique(titles.begin(), titles.end());
+        vector<Song*> songs;
+        for (const string& title : unique) {
+            auto it = byTitle.find(title);
+            if (it != byTitle.end()) {
+                songs.insert(songs.end(), it->second.begin(), it->second.end());
+            }
+        }
+        return removeNodes(songs);
+    }
+
+    // Remove every song by an artist; returns the number removed
+    size_t removeArtist(const string& artist) {
+        auto it = byArtist.find(artist);
+        if (it == byArtist.end()) {
+            return 0;
+        }
+        vector<Song*> songs = it->second;
+        return removeNodes(songs);
+    }
+
+    // Stable bottom-up merge sort of the list, relinking next pointers with
+    // no recursion and no allocation, in O(n log n). runs[i] holds a sorted
+    // run of 2^i songs; each song taken off the list carries into the runs
+    // like adding 1 to a binary counter, so most merges are of short runs
+    // of songs that were just touched and are still in cache.
+    template <typename Less>
+    void sortBy(Less less) {
+        const int MAX_RUNS = 64;
+        Song* runs[MAX_RUNS] = {};
+        Song* rest = head;
+        while (rest) {
+            Song* carry = rest;
+            rest = rest->next;
+            carry->next = nullptr;
+            int i = 0;
+            for (; runs[i]; i++) {
+                carry = mergeChains(runs[i], carry, less);
+                runs[i] = nullptr;
+            }
+            runs[i] = carry;
+        }
+        // Higher runs hold earlier songs
+        Song* sorted = nullptr;
+        for (int i = 0; i < MAX_RUNS; i++) {
+            if (runs[i]) {
+                sorted = mergeChains(runs[i], sorted, less);
+            }
+        }
+        head = sorted;
+        relinked();
+    }
+
+    // Fisher-Yates shuffle in O(n): the songs are put in a temporary array
+    // of pointers, shuffled there and relinked in the new order
+    void shuffle(mt19937& random) {
+        vector<Song*> order;
+        order.reserve(size());
+        for (Song* song = head; song; song = song->next) {
+            order.push_back(song);
+        }
+        for (size_t i = order.size(); i > 1; i--) {
+            size_t j = uniform_int_distribution<size_t>(0, i - 1)(random);
+            swap(order[i - 1], order[j]);
+        }
+        for (size_t i = 0; i + 1 < order.size(); i++) {
+            order[i]->next = order[i + 1];
+        }
+        if (!order.empty()) {
+            head = order[0];
+            order.back()->next = nullptr;
+        }
+        relinked();
+    }
+
+    // Stable partition in one pass: songs matching the predicate move to
+    // the front, keeping their order; returns how many matched
+    template <typename Predicate>
+    size_t partition(Predicate matches) {
+        Song* front = nullptr;
+        Song* back = nullptr;
+        Song** frontLink = &front;
+        Song** backLink = &back;
+        size_t matched = 0;
+        for (Song* song = head; song; song = song->next) {
+            if (matches(*song)) {
+                *frontLink = song;
+                frontLink = &song->next;
+                matched++;
+            } else {
+                *backLink = song;
+                backLink = &song->next;
+            }
+        }
+        *backLink = nullptr;
+        *frontLink = back;
+        head = front;
+        if (matched > 0 && matched < size()) {
+            relinked();
+        }
+        return matched;
+    }
+
+    // Move every song of other to the end of this playlist, leaving other
+    // empty. Songs this playlist already has (same title and artist) are
+    // dropped from other first; returns how many were dropped. Linking the
+    // lists is O(1) and joining the treaps O(log n), but finding duplicates
+    // and merging the hash indexes touch every song of the smaller
+    // playlist, so the splice as a whole is O(min(n, m)).
+    size_t splice(Playlist& other) {
+        if (&other == this || !other.head) {
+            return 0;
+        }
+        vector<Song*> duplicates;
+        if (size() < other.size()) {
+            for (Song* song = head; song; song = song->next) {
+                if (Song* duplicate = other.findSong(song->title, song->artist)) {
+                    duplicates.push_back(duplicate);
+                }
+            }
         } else {
-            cout << "Song not found!\n";
+            for (Song* song = other.head; song; song = song->next) {
+                if (findSong(song->title, song->artist)) {
+                    duplicates.push_back(song);
+                }
+            }
+        }
+        other.removeNodes(duplicates);
+        if (!other.head) {
+            return duplicates.size();
+        }
+        if (tail) {
+            tail->next = other.head;
+        } else {
+            head = other.head;
         }
+        tail = other.tail;
+        setRoot(merge(root, other.root));
+        mergeIndex(byTitle, other.byTitle, &Song::titleSlot);
+        mergeIndex(byArtist, other.byArtist, &Song::artistSlot);
+        other.head = other.tail = other.root = nullptr;
+        return duplicates.size();
+    }
+
+    // Sort the playlist by artist, keeping the order of each artist's songs
+    void sortByArtist() {
+        sortBy([](const Song& a, const Song& b) { return a.artist < b.artist; });
+        cout << "Sorted " << size() << " songs by artist\n";
+    }
+
+    // Sort the playlist by title
+    void sortByTitle() {
+        sortBy([](const Song& a, const Song& b) { return a.title < b.title; });
+        cout << "Sorted " << size() << " songs by title\n";
+    }
+
+    // Shuffle the playlist
+    void shuffleSongs(mt19937& random) {
+        shuffle(random);
+        cout << "Shuffled " << size() << " songs\n";
+    }
+
+    // Move all songs by an artist to the front
+    void moveArtistToFront(string artist) {
+        size_t moved = partition([&artist](const Song& song) { return song.artist == artist; });
+        if (moved == 0) {
+            cout << "No songs by " << artist << "!\n";
+            return;
+        }
+        cout << "Moved " << moved << " song" << (moved == 1 ? "" : "s") << " by " << artist << " to the front\n";
+    }
+
+    // Remove all songs by an artist
+    void removeArtistSongs(string artist) {
+        size_t removed = removeArtist(artist);
+        if (removed == 0) {
+            cout << "No songs by " << artist << "!\n";
+            return;
+        }
+        cout << "Removed " << removed << " song" << (removed == 1 ? "" : "s") << " by " << artist << "\n";
     }
 
     // Display playlist
@@ -88,14 +694,271 @@ public:
     }
 };
 
+// The original playlist design, kept for the benchmarks: a plain singly
+// linked list that walks from head for every append and positional access
+class UnindexedPlaylist {
+private:
+    Song* head;
+
+public:
+    UnindexedPlaylist() : head(nullptr) {}
+
+    void append(const string& title, const string& artist) {
+        Song* newSong = new Song(title, artist);
+        if (!head) {
+            head = newSong;
+            return;
+        }
+        Song* current = head;
+        while (current->next) {
+            current = current->next;
+        }
+        current->next = newSong;
+    }
+
+    Song* songAt(size_t index) const {
+        Song* current = head;
+        while (current && index-- > 0) {
+            current = current->next;
+        }
+        return current;
+    }
+
+    void insertAt(size_t index, const string& title, const string& artist) {
+        Song* newSong = new Song(title, artist);
+        if (index == 0 || !head) {
+            newSong->next = head;
+            head = newSong;
+            return;
+        }
+        Song* prev = songAt(index - 1);
+        newSong->next = prev->next;
+        prev->next = newSong;
+    }
+
+    // The original removeSong: a linear scan comparing titles
+    bool removeTitle(const string& title) {
+        Song* prev = nullptr;
+        Song* current = head;
+        while (current && current->title != title) {
+            prev = current;
+            current = current->next;
+        }
+        if (!current) {
+            return false;
+        }
+        if (prev) {
+            prev->next = current->next;
+        } else {
+            head = current->next;
+        }
+        delete current;
+        return true;
+    }
+
+    ~UnindexedPlaylist() {
+        Song* current = head;
+        while (current) {
+            Song* next = current->next;
+            delete current;
+            current = next;
+        }
+    }
+};
+
+// Seconds elapsed since a start time
+double secondsSince(chrono::steady_clock::time_point start) {
+    return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+// Build playlists of growing size, then play random song numbers and insert
+// at random positions: the original list against the indexed one
+template <typename List>
+void benchmarkPlaylist(const string& name, size_t songs, int lookups, int inserts) {
+    mt19937 rng(songs);
+    List playlist;
+    auto start = chrono::steady_clock::now();
+    for (size_t i = 0; i < songs; i++) {
+        playlist.append("Song " + to_string(i), "Artist " + to_string(i % 1000));
+    }
+    double buildSeconds = secondsSince(start);
+
+    start = chrono::steady_clock::now();
+    volatile size_t checksum = 0;
+    for (int i = 0; i < lookups; i++) {
+        checksum = checksum + playlist.songAt(rng() % songs)->title.size();
+    }
+    double lookupSeconds = secondsSince(start);
+
+    start = chrono::steady_clock::now();
+    for (int i = 0; i < inserts; i++) {
+        playlist.insertAt(rng() % (songs + i), "Inserted " + to_string(i), "Artist");
+    }
+    double insertSeconds = secondsSince(start);
+
+    cout << left << setw(24) << name << right << setw(10) << songs << fixed << setprecision(2) << setw(12)
+         << buildSeconds * 1000 << setw(14) << lookupSeconds * 1e6 / lookups << setw(14)
+         << insertSeconds * 1e6 / inserts << "\n" << left;
+}
+
+// Pull 10,000 songs out of a 1M-song playlist (100 artists with 10,000 songs
+// each): by title one at a time, as one removeAll, and as a whole artist's
+// catalog. The linear scan is timed on a sample and scaled up.
+void benchmarkRemovals() {
+    const size_t SONGS = 1000000;
+    const size_t ARTISTS = 100;
+    const int REMOVALS = 10000;
+    const int SCAN_SAMPLE = 50;
+
+    mt19937 rng(48);
+    vector<string> titles;
+    for (int i = 0; i < REMOVALS; i++) {
+        titles.push_back("Song " + to_string(rng() % SONGS));
+    }
+    auto artistOf = [](size_t i) { return "Artist " + to_string(i % ARTISTS); };
+
+    cout << "\n===== Removing " << REMOVALS << " songs from a " << SONGS << "-song playlist =====\n";
+    cout << left << setw(40) << "Method" << right << setw(12) << "Removed" << setw(14) << "Total ms" << "\n"
+         << left;
+    auto printRow = [](const string& name, size_t removed, double seconds) {
+        cout << setw(40) << name << right << setw(12) << removed << fixed << setprecision(2) << setw(14)
+             << seconds * 1000 << "\n" << left;
+    };
+
+    {
+        UnindexedPlaylist playlist;
+        for (size_t i = SONGS; i-- > 0;) {
+            playlist.insertAt(0, "Song " + to_string(i), artistOf(i));
+        }
+        size_t removed = 0;
+        auto start = chrono::steady_clock::now();
+        for (int i = 0; i < SCAN_SAMPLE; i++) {
+            removed += playlist.removeTitle(titles[i]);
+        }
+        double seconds = secondsSince(start) * REMOVALS / SCAN_SAMPLE;
+        printRow("Linear scan, " + to_string(SCAN_SAMPLE) + " timed and scaled", removed, seconds);
+    }
+
+    auto build = [&](Playlist& playlist) {
+        for (size_t i = 0; i < SONGS; i++) {
+            playlist.append("Song " + to_string(i), artistOf(i));
+        }
+    };
+    {
+        Playlist playlist;
+        build(playlist);
+        size_t removed = 0;
+        auto start = chrono::steady_clock::now();
+        for (const string& title : titles) {
+            removed += playlist.removeTitle(title);
+        }
+        printRow("Hash index, removeSong per title", removed, secondsSince(start));
+    }
+    {
+        Playlist playlist;
+        build(playlist);
+        auto start = chrono::steady_clock::now();
+        size_t removed = playlist.removeAll(titles);
+        printRow("Hash index, removeAll(titles)", removed, secondsSince(start));
+    }
+    {
+        Playlist playlist;
+        build(playlist);
+        unordered_set<string> doomed(titles.begin(), titles.end());
+        auto start = chrono::steady_clock::now();
+        size_t removed = playlist.removeIf([&doomed](const Song& song) { return doomed.count(song.title) > 0; });
+        printRow("removeIf(title in set), one pass", removed, secondsSince(start));
+    }
+    {
+        Playlist playlist;
+        build(playlist);
+        auto start = chrono::steady_clock::now();
+        size_t removed = playlist.removeArtist(artistOf(7));
+        printRow("Hash index, one artist's catalog", removed, secondsSince(start));
+    }
+}
+
+// Bulk reorders of large playlists and splicing two playlists together,
+// with the heap allocations each one made
+void benchmarkBulkOperations() {
+    cout << "\n===== Bulk playlist operations =====\n";
+    cout << left << setw(36) << "Operation" << right << setw(10) << "Songs" << setw(12) << "ms" << setw(14)
+         << "Allocations" << "\n" << left;
+
+    for (size_t songs : {100000, 1000000}) {
+        mt19937 rng(songs);
+        auto build = [&](Playlist& playlist, size_t count, size_t first) {
+            for (size_t i = first; i < first + count; i++) {
+                playlist.append("Song " + to_string(i), "Artist " + to_string(rng() % 1000));
+            }
+        };
+        auto timeRow = [&](const string& name, auto operation) {
+            long long allocations = allocationCount;
+            auto start = chrono::steady_clock::now();
+            operation();
+            double seconds = secondsSince(start);
+            cout << setw(36) << name << right << setw(10) << songs << fixed << setprecision(2) << setw(12)
+                 << seconds * 1000 << setw(14) << allocationCount - allocations << "\n" << left;
+        };
+
+        Playlist playlist;
+        build(playlist, songs, 0);
+        timeRow("Merge sort by artist", [&]() {
+            playlist.sortBy([](const Song& a, const Song& b) { return a.artist < b.artist; });
+        });
+        timeRow("Merge sort by title", [&]() {
+            playlist.sortBy([](const Song& a, const Song& b) { return a.title < b.title; });
+        });
+        timeRow("Fisher-Yates shuffle", [&]() { playlist.shuffle(rng); });
+        timeRow("Partition (one artist to front)", [&]() {
+            playlist.partition([](const Song& song) { return song.artist == "Artist 7"; });
+        });
+
+        Playlist first;
+        Playlist second;
+        build(first, songs / 2, 0);
+        build(second, songs / 2, songs / 2);
+        timeRow("Splice two halves", [&]() { first.splice(second); });
+        if (first.size() != songs || second.size() != 0) {
+            cout << "Error: splice lost songs!\n";
+        }
+    }
+}
+
+void runBenchmarks() {
+    const int LOOKUPS = 2000;
+    const int INSERTS = 2000;
+
+    cout << "\n===== Playlist benchmarks (" << LOOKUPS << " plays, " << INSERTS << " inserts) =====\n";
+    cout << left << setw(24) << "Playlist" << right << setw(10) << "Songs" << setw(12) << "Build ms" << setw(14)
+         << "Play #k us" << setw(14) << "Insert us" << "\n" << left;
+    for (size_t songs : {5000, 20000}) {
+        benchmarkPlaylist<UnindexedPlaylist>("Walk from head", songs, LOOKUPS, INSERTS);
+    }
+    for (size_t songs : {5000, 20000, 100000, 1000000}) {
+        benchmarkPlaylist<Playlist>("Tail + treap index", songs, LOOKUPS, INSERTS);
+    }
+    benchmarkRemovals();
+    benchmarkBulkOperations();
+    cout << "=====================================\n";
+}
+
 // Display menu
 void displayMenu() {
     cout << "\n===== Playlist Manager Menu =====\n";
     cout << "1. Add new song\n";
     cout << "2. Remove song\n";
     cout << "3. Display playlist\n";
-    cout << "4. Exit\n";
-    cout << "Enter your choice (1-4): ";
+    cout << "4. Insert song at position\n";
+    cout << "5. Play song by number\n";
+    cout << "6. Remove all songs by an artist\n";
+    cout << "7. Sort by artist\n";
+    cout << "8. Sort by title\n";
+    cout << "9. Shuffle\n";
+    cout << "10. Move songs by an artist to the front\n";
+    cout << "11. Run benchmarks\n";
+    cout << "12. Exit\n";
+    cout << "Enter your choice (1-12): ";
 }
 
 void clearInputBuffer() {
@@ -106,14 +969,16 @@ void clearInputBuffer() {
 int main() {
     Playlist playlist;
     int choice;
+    size_t position;
     string title, artist;
+    mt19937 shuffleRandom(random_device{}());
     bool running = true;
 
     cout << "Welcome to the Playlist Manager!\n";
 
     while (running) {
         displayMenu();
-        
+
         if (!(cin >> choice)) {
             cout << "Invalid input. Please enter a number.\n";
             clearInputBuffer();
@@ -129,24 +994,78 @@ int main() {
                 getline(cin, artist);
                 playlist.addSong(title, artist);
                 break;
-                
+
             case 2:
                 cout << "Enter song title to remove: ";
                 getline(cin, title);
                 playlist.removeSong(title);
                 break;
-                
+
             case 3:
                 playlist.displayPlaylist();
                 break;
-                
+
             case 4:
+                cout << "Enter position (1 = first): ";
+                if (!(cin >> position)) {
+                    cout << "Invalid position. Please enter a number.\n";
+                    clearInputBuffer();
+                    break;
+                }
+                clearInputBuffer();
+                cout << "Enter song title: ";
+                getline(cin, title);
+                cout << "Enter artist name: ";
+                getline(cin, artist);
+                playlist.insertSong(position, title, artist);
+                break;
+
+            case 5:
+                cout << "Enter song number: ";
+                if (!(cin >> position)) {
+                    cout << "Invalid number. Please enter a number.\n";
+                    clearInputBuffer();
+                    break;
+                }
+                clearInputBuffer();
+                playlist.playSong(position);
+                break;
+
+            case 6:
+                cout << "Enter artist name: ";
+                getline(cin, artist);
+                playlist.removeArtistSongs(artist);
+                break;
+
+            case 7:
+                playlist.sortByArtist();
+                break;
+
+            case 8:
+                playlist.sortByTitle();
+                break;
+
+            case 9:
+                playlist.shuffleSongs(shuffleRandom);
+                break;
+
+            case 10:
+                cout << "Enter artist name: ";
+                getline(cin, artist);
+                playlist.moveArtistToFront(artist);
+                break;
+
+            case 11:
+                runBenchmarks();
+                break;
+
+            case 12:
                 cout << "Exiting Playlist Manager. Goodbye!\n";
                 running = false;
                 break;
-                
+
             default:
-                cout << "Invalid choice. Please enter a number between 1 and 4.\n";
+                cout << "Invalid choice. Please enter a number between 1 and 12.\n";
         }
     }
 
@@ -1,64 +1,1663 @@
 #include <iostream>
 #include <string>
 #include <limits>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <iomanip>
+#include <memory>
+#include <cstdint>
+#include <unordered_set>
+#include <fstream>
+#include <iterator>
+#include <cstring>
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <algorithm>
 
 using namespace std;
 
+// One edit between two text states: at position, removed was replaced by inserted
+struct EditOp {
+    size_t position;
+    string removed;
+    string inserted;
+};
+
+// Smallest single edit that turns before into after: everything between the
+// common prefix and the common suffix of the two states
+EditOp diffStates(const string& before, const string& after) {
+    size_t limit = min(before.size(), after.size());
+    size_t prefix = 0;
+    while (prefix < limit && before[prefix] == after[prefix]) {
+        prefix++;
+    }
+    size_t suffix = 0;
+    while (suffix < limit - prefix && before[before.size() - 1 - suffix] == after[after.size() - 1 - suffix]) {
+        suffix++;
+    }
+    return {prefix, before.substr(prefix, before.size() - prefix - suffix),
+            after.substr(prefix, after.size() - prefix - suffix)};
+}
+
+void applyEdit(string& text, const EditOp& edit) {
+    text.replace(edit.position, edit.removed.size(), edit.inserted);
+}
+
+// Undo history stored as edits instead of full copies.
+// Entry i holds the edit from state i-1 to state i (before state 0 the
+// document is empty), and every checkpointInterval-th entry also keeps a full
+// copy of its state (in place of the inserted text, which the checkpoint
+// already contains). Undo reverts the last edit on the current text; any
+// older state is rebuilt from the nearest checkpoint at or before it by
+// replaying fewer than checkpointInterval edits.
+class DeltaHistory {
+private:
+    struct Entry {
+        EditOp edit;
+        size_t length;      // Length of the state after this edit
+        bool hasCheckpoint;
+        string checkpoint;
+    };
+
+    vector<Entry> entries;
+    string current;
+    size_t checkpointInterval;
+
+public:
+    explicit DeltaHistory(size_t interval = 16) : checkpointInterval(interval) {}
+
+    bool empty() const { return entries.empty(); }
+    size_t size() const { return entries.size(); }
+    const string& currentState() const { return current; }
+
+    void push(const string& state) {
+        Entry entry;
+        entry.edit = diffStates(current, state);
+        entry.length = state.size();
+        entry.hasCheckpoint = entries.size() % checkpointInterval == 0;
+        if (entry.hasCheckpoint) {
+            entry.checkpoint = state;
+            entry.edit.inserted.clear();
+            entry.edit.inserted.shrink_to_fit();
+        }
+        entries.push_back(std::move(entry));
+        current = state;
+    }
+
+    // Drop the newest state, going back to the one before it
+    void pop() {
+        const Entry& last = entries.back();
+        size_t previousLength = entries.size() > 1 ? entries[entries.size() - 2].length : 0;
+        size_t insertedLength = last.length + last.edit.removed.size() - previousLength;
+        current.replace(last.edit.position, insertedLength, last.edit.removed);
+        entries.pop_back();
+    }
+
+    // Rebuild state index (0 = oldest)
+    string stateAt(size_t index) const {
+        size_t base = index - index % checkpointInterval;
+        string text = entries[base].checkpoint;
+        for (size_t i = base + 1; i <= index; i++) {
+            applyEdit(text, entries[i].edit);
+        }
+        return text;
+    }
+
+    // Bytes held by the history, including the current text
+    size_t memoryUsage() const {
+        size_t bytes = sizeof(*this) + entries.capacity() * sizeof(Entry) + current.capacity();
+        for (const Entry& entry : entries) {
+            bytes += entry.edit.removed.capacity() + entry.edit.inserted.capacity() + entry.checkpoint.capacity();
+        }
+        return bytes;
+    }
+
+    // Bytes the same history would take as one full string per state
+    size_t snapshotMemoryUsage() const {
+        size_t bytes = 0;
+        for (const Entry& entry : entries) {
+            bytes += sizeof(string) + entry.length;
+        }
+        return bytes;
+    }
+};
+
+// Persistent rope: an implicit treap whose nodes hold chunks of text.
+// Each node's key is its position in the document, found from subtree
+// sizes, and random priorities keep the tree balanced in expectation.
+// insert and erase split and merge the tree in O(log n), copying only the
+// nodes on the paths they touch (the chunks themselves are shared even by
+// copied nodes); every other node is shared with the
+// previous version, so keeping old versions for undo costs O(log n) nodes
+// per edit, and switching versions is just swapping a root pointer.
+class Rope {
+private:
+    static const size_t CHUNK_SIZE = 256;
+
+    struct Node;
+    typedef shared_ptr<const Node> NodePtr;
+    typedef shared_ptr<const string> ChunkPtr;
+
+    struct Node {
+        ChunkPtr chunk;
+        size_t size;  // Characters in this subtree
+        uint32_t priority;
+        NodePtr left;
+        NodePtr right;
+    };
+
+    NodePtr root;
+
+    explicit Rope(NodePtr node) : root(node) {}
+
+    static uint32_t randomPriority() {
+        static mt19937 rng(12345);
+        return rng();
+    }
+
+    static size_t sizeOf(const NodePtr& node) { return node ? node->size : 0; }
+
+    // Bytes allocated for nodes and chunks so far, 16 bytes per make_shared
+    // allocation for its control block
+    static size_t& allocated() {
+        static size_t bytes = 0;
+        return bytes;
+    }
+
+    static ChunkPtr makeChunk(string text) {
+        allocated() += sizeof(string) + text.capacity() + 16;
+        return make_shared<const string>(std::move(text));
+    }
+
+    static NodePtr makeNode(ChunkPtr chunk, uint32_t priority, NodePtr left, NodePtr right) {
+        allocated() += sizeof(Node) + 16;
+        shared_ptr<Node> node = make_shared<Node>();
+        node->size = sizeOf(left) + chunk->size() + sizeOf(right);
+        node->chunk = std::move(chunk);
+        node->priority = priority;
+        node->left = std::move(left);
+        node->right = std::move(right);
+        return node;
+    }
+
+    // Split into the first position characters and the rest
+    static pair<NodePtr, NodePtr> split(const NodePtr& node, size_t position) {
+        if (!node) {
+            return {nullptr, nullptr};
+        }
+        size_t leftSize = sizeOf(node->left);
+        size_t chunkEnd = leftSize + node->chunk->size();
+        if (position <= leftSize) {
+            pair<NodePtr, NodePtr> parts = split(node->left, position);
+            return {parts.first, makeNode(node->chunk, node->priority, parts.second, node->right)};
+        }
+        if (position >= chunkEnd) {
+            pair<NodePtr, NodePtr> parts = split(node->right, position - chunkEnd);
+            return {makeNode(node->chunk, node->priority, node->left, parts.first), parts.second};
+        }
+        // The split point falls inside this node's chunk
+        size_t offset = position - leftSize;
+        ChunkPtr before = makeChunk(node->chunk->substr(0, offset));
+        ChunkPtr after = makeChunk(node->chunk->substr(offset));
+        return {makeNode(before, node->priority, node->left, nullptr),
+                makeNode(after, node->priority, nullptr, node->right)};
+    }
+
+    // Concatenate two trees; every character of a comes before b
+    static NodePtr merge(const NodePtr& a, const NodePtr& b) {
+        if (!a) {
+            return b;
+        }
+        if (!b) {
+            return a;
+        }
+        if (a->priority > b->priority) {
+            return makeNode(a->chunk, a->priority, a->left, merge(a->right, b));
+        }
+        return makeNode(b->chunk, b->priority, merge(a, b->left), b->right);
+    }
+
+    // Balanced tree of fresh chunk nodes for text in O(n): nodes are laid out
+    // in order and linked into a treap with a stack (Cartesian tree build)
+    static NodePtr build(const string& text) {
+        vector<shared_ptr<Node>> stack;
+        for (size_t start = 0; start < text.size(); start += CHUNK_SIZE) {
+            allocated() += sizeof(Node) + 16;
+            shared_ptr<Node> node = make_shared<Node>();
+            node->chunk = makeChunk(text.substr(start, CHUNK_SIZE));
+            node->priority = randomPriority();
+            shared_ptr<Node> last;
+            while (!stack.empty() && stack.back()->priority < node->priority) {
+                last = stack.back();
+                stack.pop_back();
+            }
+            node->left = last;
+            if (!stack.empty()) {
+                stack.back()->right = node;
+            }
+            stack.push_back(node);
+        }
+        if (stack.empty()) {
+            return nullptr;
+        }
+        return fixSizes(stack.front());
+    }
+
+    static NodePtr fixSizes(const shared_ptr<Node>& node) {
+        if (!node) {
+            return nullptr;
+        }
+        fixSizes(const_pointer_cast<Node>(node->left));
+        fixSizes(const_pointer_cast<Node>(node->right));
+        node->size = sizeOf(node->left) + node->chunk->size() + sizeOf(node->right);
+        return node;
+    }
+
+    static void appendTo(const NodePtr& node, string& text) {
+        if (!node) {
+            return;
+        }
+        appendTo(node->left, text);
+        text += *node->chunk;
+        appendTo(node->right, text);
+    }
+
+    // 16 bytes per make_shared allocation for its control block
+    static void countNodes(const NodePtr& node, unordered_set<const void*>& seen, size_t& bytes) {
+        if (!node || !seen.insert(node.get()).second) {
+            return;  // Already counted through another version
+        }
+        bytes += sizeof(Node) + 16;
+        if (seen.insert(node->chunk.get()).second) {
+            bytes += sizeof(string) + node->chunk->capacity() + 16;
+        }
+        countNodes(node->left, seen, bytes);
+        countNodes(node->right, seen, bytes);
+    }
+
+public:
+    Rope() {}
+    explicit Rope(const string& text) : root(build(text)) {}
+
+    size_t length() const { return sizeOf(root); }
+
+    // Running total of bytes allocated by all ropes; the difference across an
+    // edit is the memory that edit's new version added
+    static size_t bytesAllocated() { return allocated(); }
+
+    // New version with text inserted before position
+    Rope insert(size_t position, const string& text) const {
+        if (text.empty()) {
+            return *this;
+        }
+        pair<NodePtr, NodePtr> parts = split(root, position);
+        return Rope(merge(merge(parts.first, build(text)), parts.second));
+    }
+
+    // New version without the count characters starting at position
+    Rope erase(size_t position, size_t count) const {
+        if (count == 0) {
+            return *this;
+        }
+        pair<NodePtr, NodePtr> head = split(root, position);
+        pair<NodePtr, NodePtr> tail = split(head.second, count);
+        return Rope(merge(head.first, tail.second));
+    }
+
+    // New version with an edit applied
+    Rope apply(const EditOp& edit) const {
+        return erase(edit.position, edit.removed.size()).insert(edit.position, edit.inserted);
+    }
+
+    // New version with an edit taken back
+    Rope revert(const EditOp& edit) const {
+        return erase(edit.position, edit.inserted.size()).insert(edit.position, edit.removed);
+    }
+
+    // The count characters starting at position
+    string substr(size_t position, size_t count) const {
+        pair<NodePtr, NodePtr> head = split(root, position);
+        pair<NodePtr, NodePtr> tail = split(head.second, count);
+        string text;
+        text.reserve(sizeOf(tail.first));
+        appendTo(tail.first, text);
+        return text;
+    }
+
+    string toString() const {
+        string text;
+        text.reserve(length());
+        appendTo(root, text);
+        return text;
+    }
+
+    // Bytes held by a set of versions, counting shared nodes once
+    static size_t memoryUsage(const vector<Rope>& versions) {
+        unordered_set<const void*> seen;
+        size_t bytes = versions.capacity() * sizeof(Rope);
+        for (const Rope& version : versions) {
+            countNodes(version.root, seen, bytes);
+        }
+        return bytes;
+    }
+};
+
+// Undo/redo stack of unbounded depth.
+// Entries live in fixed-size segments reached through a ring of segment
+// pointers, so push, undo, redo and evicting the oldest entry are all O(1)
+// amortized and nothing is ever copied when the stack grows. Positions are
+// global counters: entries [low, cursor) can be undone to, and entries
+// [cursor, high) are undone states kept for redo until the next push. Each
+// entry carries a cost in bytes; when the total exceeds the memory budget,
+// the oldest entries are evicted (the current state is always kept).
+template <typename T>
+class UndoRedoStack {
+private:
+    static const size_t SEGMENT_SIZE = 64;
+
+    struct Segment {
+        T items[SEGMENT_SIZE];
+        size_t costs[SEGMENT_SIZE];
+    };
+
+    vector<Segment*> ring;  // Segment number s is at ring[s % ring.size()]
+    size_t firstSegment;    // Segments [firstSegment, endSegment) are allocated
+    size_t endSegment;
+    Segment* spare;         // One recycled segment
+    size_t low, cursor, high;
+    size_t usedBytes;
+    size_t budget;
+    size_t evicted;
+
+    Segment* segmentFor(size_t index) const { return ring[(index / SEGMENT_SIZE) % ring.size()]; }
+    T& itemAt(size_t index) const { return segmentFor(index)->items[index % SEGMENT_SIZE]; }
+    size_t& costAt(size_t index) const { return segmentFor(index)->costs[index % SEGMENT_SIZE]; }
+
+    void releaseSegment(size_t segmentNumber) {
+        Segment*& slot = ring[segmentNumber % ring.size()];
+        if (spare) {
+            delete slot;
+        } else {
+            spare = slot;
+        }
+        slot = nullptr;
+    }
+
+    // Allocate the next segment at the top, doubling the ring if every slot
+    // is in use
+    void addSegment() {
+        if (endSegment - firstSegment == ring.size()) {
+            vector<Segment*> larger(ring.size() * 2, nullptr);
+            for (size_t s = firstSegment; s < endSegment; s++) {
+                larger[s % larger.size()] = ring[s % ring.size()];
+            }
+            ring.swap(larger);
+        }
+        Segment* segment = spare ? spare : new Segment();
+        spare = nullptr;
+        ring[endSegment % ring.size()] = segment;
+        endSegment++;
+    }
+
+    // Drop the oldest entry
+    void evictOldest() {
+        usedBytes -= costAt(low);
+        itemAt(low) = T();
+        low++;
+        evicted++;
+        if (low % SEGMENT_SIZE == 0) {
+            releaseSegment(firstSegment++);
+        }
+    }
+
+public:
+    explicit UndoRedoStack(size_t budgetBytes)
+        : ring(4, nullptr), firstSegment(0), endSegment(0), spare(nullptr), low(0), cursor(0), high(0),
+          usedBytes(0), budget(budgetBytes), evicted(0) {}
+
+    ~UndoRedoStack() {
+        for (Segment* segment : ring) {
+            delete segment;
+        }
+        delete spare;
+    }
+
+    UndoRedoStack(const UndoRedoStack&) = delete;
+    UndoRedoStack& operator=(const UndoRedoStack&) = delete;
+
+    bool hasCurrent() const { return cursor > low; }
+    const T& current() const { return itemAt(cursor - 1); }
+
+    // Undo may go back to the empty document only if nothing was evicted
+    bool canUndo() const { return cursor > low + 1 || (cursor == 1 && low == 0); }
+    bool canRedo() const { return cursor < high; }
+    size_t undoDepth() const { return cursor - low; }
+    size_t redoDepth() const { return high - cursor; }
+    size_t memoryUsed() const { return usedBytes; }
+    size_t memoryBudget() const { return budget; }
+    size_t evictedCount() const { return evicted; }
+
+    // Entry at offset i from the oldest kept one, for display
+    const T& at(size_t i) const { return itemAt(low + i); }
+
+    // Push a new current state, discarding any redo entries
+    void push(const T& item, size_t cost) {
+        while (high > cursor) {
+            high--;
+            usedBytes -= costAt(high);
+            itemAt(high) = T();
+        }
+        while (endSegment > firstSegment && (endSegment - 1) * SEGMENT_SIZE >= high) {
+            releaseSegment(--endSegment);
+        }
+        if (cursor / SEGMENT_SIZE == endSegment) {
+            addSegment();
+        }
+        itemAt(cursor) = item;
+        costAt(cursor) = cost;
+        cursor++;
+        high = cursor;
+        usedBytes += cost;
+        while (usedBytes > budget && cursor - low > 1) {
+            evictOldest();
+        }
+    }
+
+    void undo() { cursor--; }
+
+    void redo() { cursor++; }
+
+    void setBudget(size_t budgetBytes) {
+        budget = budgetBytes;
+        while (usedBytes > budget && cursor - low > 1) {
+            evictOldest();
+        }
+    }
+
+    // Drop every entry. Positions keep counting up, so the next push starts
+    // a history that cannot be undone past its first entry
+    void clear() {
+        for (size_t i = low; i < high; i++) {
+            itemAt(i) = T();
+        }
+        while (endSegment > firstSegment) {
+            releaseSegment(--endSegment);
+        }
+        low = cursor = high;
+        firstSegment = endSegment = high / SEGMENT_SIZE;
+        if (high % SEGMENT_SIZE != 0) {
+            addSegment();
+        }
+        usedBytes = 0;
+    }
+};
+
+// Append-only journal of edits kept in a memory-mapped file, so an editing
+// session survives the process.
+// The file starts with a header (end of the records, offset of the current
+// state, offset the snapshot file was taken at) followed by records
+//   [size][position][removed length][inserted length][removed][inserted][size]
+// Offsets name states: the state at offset o is the document after every
+// record before o. The size is repeated at the end of each record so undo can
+// walk the journal backward from any state. Records after the current state
+// are undone edits; a new edit truncates them and appends at the cursor.
+// On close the current text is written to a snapshot file, so reopening only
+// replays the records between the snapshot and the cursor.
+class EditJournal {
+private:
+    struct Header {
+        uint64_t magic;
+        uint64_t end;
+        uint64_t cursor;
+        uint64_t snapshotOffset;
+    };
+
+    static const uint64_t MAGIC = 0x314c4e524a544445ULL;  // "EDTJRNL1"
+    static const uint64_t NO_SNAPSHOT = ~0ULL;
+    static const size_t RECORD_OVERHEAD = 4 + 8 + 4 + 4 + 4;
+    static const size_t INITIAL_CAPACITY = 1 << 16;
+
+    string path;
+    int fd;
+    char* map;
+    size_t capacity;
+
+    Header* header() const { return reinterpret_cast<Header*>(map); }
+    string snapshotPath() const { return path + ".snapshot"; }
+
+    static uint32_t readU32(const char* src) {
+        uint32_t value;
+        memcpy(&value, src, sizeof(value));
+        return value;
+    }
+
+    static uint64_t readU64(const char* src) {
+        uint64_t value;
+        memcpy(&value, src, sizeof(value));
+        return value;
+    }
+
+    // Map the file at a new size. The old mapping is only dropped once the
+    // new one is in place, so on failure the journal is left as it was.
+    bool remap(size_t bytes) {
+        if (bytes > capacity && ftruncate(fd, bytes) != 0) {
+            cout << "Error: cannot resize " << path << ": " << strerror(errno) << "\n";
+            return false;
+        }
+        void* mapped = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        if (mapped == MAP_FAILED) {
+            cout << "Error: cannot map " << path << ": " << strerror(errno) << "\n";
+            return false;
+        }
+        if (map != nullptr) {
+            munmap(map, capacity);
+        }
+        map = static_cast<char*>(mapped);
+        capacity = bytes;
+        return true;
+    }
+
+    // Decode the record starting at offset if it is complete and consistent
+    bool decodeAt(uint64_t offset, EditOp& edit, uint64_t& next) const {
+        uint64_t limit = header()->end;
+        if (offset + RECORD_OVERHEAD > limit) {
+            return false;
+        }
+        const char* src = map + offset;
+        uint32_t size = readU32(src);
+        uint32_t removedLength = readU32(src + 12);
+        uint32_t insertedLength = readU32(src + 16);
+        if (size != RECORD_OVERHEAD + (uint64_t)removedLength + insertedLength || offset + size > limit ||
+            readU32(src + size - 4) != size) {
+            return false;
+        }
+        edit.position = readU64(src + 4);
+        edit.removed.assign(src + 20, removedLength);
+        edit.inserted.assign(src + 20 + removedLength, insertedLength);
+        next = offset + size;
+        return true;
+    }
+
+public:
+    EditJournal() : fd(-1), map(nullptr), capacity(0) {}
+    ~EditJournal() { close(); }
+
+    EditJournal(const EditJournal&) = delete;
+    EditJournal& operator=(const EditJournal&) = delete;
+
+    bool isOpen() const { return map != nullptr; }
+    uint64_t begin() const { return sizeof(Header); }
+    uint64_t end() const { return header()->end; }
+    uint64_t cursor() const { return header()->cursor; }
+    size_t fileSize() const { return capacity; }
+
+    // Open or create the journal and rebuild the current text: from the
+    // snapshot when it matches the journal, replaying only the records
+    // between the snapshot and the cursor. replayed counts those records.
+    bool open(const string& journalPath, Rope& text, size_t& replayed) {
+        path = journalPath;
+        fd = ::open(path.c_str(), O_RDWR | O_CREAT, 0644);
+        if (fd < 0) {
+            cout << "Error: cannot open " << path << ": " << strerror(errno) << "\n";
+            return false;
+        }
+        struct stat info;
+        if (fstat(fd, &info) != 0) {
+            cout << "Error: cannot stat " << path << ": " << strerror(errno) << "\n";
+            return false;
+        }
+        bool fresh = info.st_size == 0;
+        if (!remap(fresh ? INITIAL_CAPACITY : (size_t)info.st_size)) {
+            return false;
+        }
+        if (fresh) {
+            *header() = {MAGIC, begin(), begin(), NO_SNAPSHOT};
+        } else if ((size_t)info.st_size < sizeof(Header) || header()->magic != MAGIC ||
+                   header()->end > capacity || header()->cursor > header()->end) {
+            cout << "Error: " << path << " is not an edit journal\n";
+            munmap(map, capacity);
+            map = nullptr;
+            return false;
+        }
+
+        // Start from the snapshot if it was taken at a state still in the journal
+        text = Rope();
+        uint64_t offset = begin();
+        ifstream snapshot(snapshotPath(), ios::binary);
+        uint64_t snapshotOffset = 0;
+        if (header()->snapshotOffset != NO_SNAPSHOT && snapshot.read((char*)&snapshotOffset, 8) &&
+            snapshotOffset == header()->snapshotOffset && snapshotOffset <= header()->end) {
+            string contents((istreambuf_iterator<char>(snapshot)), istreambuf_iterator<char>());
+            text = Rope(contents);
+            offset = snapshotOffset;
+        }
+
+        // Replay forward to the cursor, or back when the session ended after
+        // undoing below the snapshot
+        replayed = 0;
+        EditOp edit;
+        uint64_t next;
+        while (offset < header()->cursor) {
+            if (!decodeAt(offset, edit, next)) {
+                // A torn record from a crash: drop it and everything after it
+                cout << "Warning: " << path << " ends with a damaged record; discarding it\n";
+                header()->end = header()->cursor = offset;
+                break;
+            }
+            text = text.apply(edit);
+            offset = next;
+            replayed++;
+        }
+        while (offset > header()->cursor) {
+            if (!recordBefore(offset, edit, offset)) {
+                cout << "Error: " << path << " has a damaged record before its snapshot\n";
+                munmap(map, capacity);
+                map = nullptr;
+                return false;
+            }
+            text = text.revert(edit);
+            replayed++;
+        }
+        return true;
+    }
+
+    // Append an edit at the cursor, discarding any undone records after it,
+    // and set offset to the new state. Returns false, leaving the journal
+    // unchanged, if the file could not grow to hold the record.
+    bool append(const EditOp& edit, uint64_t& offset) {
+        uint32_t size = RECORD_OVERHEAD + edit.removed.size() + edit.inserted.size();
+        if (cursor() + size > capacity) {
+            size_t bytes = capacity;
+            while (cursor() + size > bytes) {
+                bytes *= 2;
+            }
+            if (!remap(bytes)) {
+                return false;
+            }
+        }
+        Header* h = header();
+        h->end = h->cursor;
+        if (h->snapshotOffset != NO_SNAPSHOT && h->snapshotOffset > h->end) {
+            h->snapshotOffset = NO_SNAPSHOT;  // The snapshot's state was just discarded
+        }
+        uint32_t removedLength = edit.removed.size();
+        uint32_t insertedLength = edit.inserted.size();
+        uint64_t position = edit.position;
+        char* dest = map + h->end;
+        memcpy(dest, &size, 4);
+        memcpy(dest + 4, &position, 8);
+        memcpy(dest + 12, &removedLength, 4);
+        memcpy(dest + 16, &insertedLength, 4);
+        memcpy(dest + 20, edit.removed.data(), removedLength);
+        memcpy(dest + 20 + removedLength, edit.inserted.data(), insertedLength);
+        memcpy(dest + size - 4, &size, 4);
+        h->end += size;
+        h->cursor = h->end;
+        offset = h->end;
+        return true;
+    }
+
+    // Read the record that ends at offset and set start to where it begins;
+    // returns false if there is no intact record there
+    bool recordBefore(uint64_t offset, EditOp& edit, uint64_t& start) const {
+        if (offset < begin() + RECORD_OVERHEAD || offset > end()) {
+            return false;
+        }
+        uint32_t size = readU32(map + offset - 4);
+        uint64_t next;
+        if (size > offset - begin() || !decodeAt(offset - size, edit, next) || next != offset) {
+            return false;
+        }
+        start = offset - size;
+        return true;
+    }
+
+    // Read the record that starts at offset and set next to where it ends;
+    // returns false if there is no intact record there
+    bool recordAt(uint64_t offset, EditOp& edit, uint64_t& next) const { return decodeAt(offset, edit, next); }
+
+    void setCursor(uint64_t offset) { header()->cursor = offset; }
+
+    // Save the text of the state at the cursor so the next open can start
+    // from it. Written to a temporary file and renamed into place, so a crash
+    // leaves either the old snapshot or the new one.
+    bool writeSnapshot(const Rope& text) {
+        string tempPath = snapshotPath() + ".tmp";
+        ofstream snapshot(tempPath, ios::binary | ios::trunc);
+        uint64_t offset = header()->cursor;
+        string contents = text.toString();
+        snapshot.write((const char*)&offset, 8);
+        snapshot.write(contents.data(), contents.size());
+        snapshot.close();
+        if (!snapshot || rename(tempPath.c_str(), snapshotPath().c_str()) != 0) {
+            cout << "Error: cannot write " << snapshotPath() << "\n";
+            return false;
+        }
+        header()->snapshotOffset = offset;
+        return true;
+    }
+
+    // Flush the journal, trim the file to its records and unmap it
+    void close() {
+        if (map != nullptr) {
+            uint64_t end = header()->end;
+            msync(map, capacity, MS_SYNC);
+            munmap(map, capacity);
+            map = nullptr;
+            if (ftruncate(fd, end) != 0) {
+                cout << "Warning: cannot trim " << path << ": " << strerror(errno) << "\n";
+            }
+        }
+        if (fd >= 0) {
+            ::close(fd);
+            fd = -1;
+        }
+    }
+
+    // Delete a session's journal and snapshot files
+    static void remove(const string& journalPath) {
+        unlink(journalPath.c_str());
+        unlink((journalPath + ".snapshot").c_str());
+        unlink((journalPath + ".snapshot.tmp").c_str());
+    }
+};
+
+// Generic stacks. All three share one interface: push returns false when the
+// stack cannot take the item, pop moves the top item into out and returns
+// false when the stack is empty.
+
+// Fixed-capacity stack in an inline array; never allocates
+template <typename T, size_t N>
+class FixedStack {
+private:
+    T items[N];
+    size_t count;
+
+public:
+    FixedStack() : count(0) {}
+
+    bool push(const T& item) {
+        if (count == N) {
+            return false;
+        }
+        items[count++] = item;
+        return true;
+    }
+
+    bool pop(T& out) {
+        if (count == 0) {
+            return false;
+        }
+        out = std::move(items[--count]);
+        return true;
+    }
+
+    const T& top() const { return items[count - 1]; }
+    bool empty() const { return count == 0; }
+    bool full() const { return count == N; }
+    size_t size() const { return count; }
+    static size_t capacity() { return N; }
+};
+
+// Stack in one contiguous array that doubles when full
+template <typename T>
+class GrowableStack {
+private:
+    unique_ptr<T[]> items;
+    size_t count;
+    size_t allocated;
+
+public:
+    explicit GrowableStack(size_t initialCapacity = 16)
+        : items(new T[max<size_t>(initialCapacity, 1)]), count(0), allocated(max<size_t>(initialCapacity, 1)) {}
+
+    bool push(const T& item) {
+        if (count == allocated) {
+            unique_ptr<T[]> larger(new T[allocated * 2]);
+            for (size_t i = 0; i < count; i++) {
+                larger[i] = std::move(items[i]);
+            }
+            items.swap(larger);
+            allocated *= 2;
+        }
+        items[count++] = item;
+        return true;
+    }
+
+    bool pop(T& out) {
+        if (count == 0) {
+            return false;
+        }
+        out = std::move(items[--count]);
+        return true;
+    }
+
+    const T& top() const { return items[count - 1]; }
+    bool empty() const { return count == 0; }
+    size_t size() const { return count; }
+    size_t capacity() const { return allocated; }
+};
+
+// Hazard pointers for the lock-free stack. Before dereferencing a shared node
+// a thread publishes its address in its own slot and checks the node is still
+// reachable; a retired node is only freed once no slot holds its address.
+// Each thread claims a slot on first use and gives it back when it exits;
+// nodes it retired but could not free yet stay with the slot for the next
+// owner to reclaim.
+class HazardPointers {
+private:
+    static const int MAX_THREADS = 128;
+    static const size_t SCAN_THRESHOLD = 2 * MAX_THREADS;
+
+    struct Retired {
+        void* ptr;
+        void (*deleter)(void*);
+    };
+
+    struct alignas(64) Slot {
+        atomic<void*> hazard;
+        atomic<bool> inUse;
+        vector<Retired> retired;  // Only touched by the owning thread
+        Slot() : hazard(nullptr), inUse(false) {}
+    };
+
+    Slot slots[MAX_THREADS];
+
+    struct SlotOwner {
+        HazardPointers* domain;
+        int index;
+        SlotOwner() : domain(nullptr), index(-1) {}
+        ~SlotOwner() {
+            if (domain) {
+                domain->slots[index].hazard.store(nullptr, memory_order_release);
+                domain->slots[index].inUse.store(false, memory_order_release);
+            }
+        }
+    };
+
+    // Find (or claim) the slot of the calling thread
+    Slot& threadSlot() {
+        thread_local SlotOwner owner;
+        if (owner.domain == this) {
+            return slots[owner.index];
+        }
+        for (int i = 0; i < MAX_THREADS; i++) {
+            bool expected = false;
+            if (slots[i].inUse.compare_exchange_strong(expected, true)) {
+                owner.domain = this;
+                owner.index = i;
+                return slots[i];
+            }
+        }
+        cerr << "Error: too many threads using the lock-free stack!\n";
+        abort();
+    }
+
+    // Free the calling thread's retired nodes that no slot protects
+    void scan(Slot& slot) {
+        vector<void*> protectedNodes;
+        for (int i = 0; i < MAX_THREADS; i++) {
+            void* hazard = slots[i].hazard.load(memory_order_seq_cst);
+            if (hazard) {
+                protectedNodes.push_back(hazard);
+            }
+        }
+        sort(protectedNodes.begin(), protectedNodes.end());
+        size_t kept = 0;
+        for (size_t i = 0; i < slot.retired.size(); i++) {
+            Retired node = slot.retired[i];
+            if (binary_search(protectedNodes.begin(), protectedNodes.end(), node.ptr)) {
+                slot.retired[kept++] = node;
+            } else {
+                node.deleter(node.ptr);
+            }
+        }
+        slot.retired.resize(kept);
+    }
+
+public:
+    HazardPointers() {}
+
+    ~HazardPointers() {
+        for (Slot& slot : slots) {
+            for (Retired& node : slot.retired) {
+                node.deleter(node.ptr);
+            }
+        }
+    }
+
+    static HazardPointers& instance() {
+        static HazardPointers domain;
+        return domain;
+    }
+
+    // Publish ptr as in use by the calling thread
+    void protect(void* ptr) { threadSlot().hazard.store(ptr, memory_order_seq_cst); }
+
+    void clear() { threadSlot().hazard.store(nullptr, memory_order_release); }
+
+    // Hand an unlinked node over for deletion once it is unprotected
+    void retire(void* ptr, void (*deleter)(void*)) {
+        Slot& slot = threadSlot();
+        slot.retired.push_back({ptr, deleter});
+        if (slot.retired.size() >= SCAN_THRESHOLD) {
+            scan(slot);
+        }
+    }
+};
+
+// Lock-free LIFO shared by any number of threads (Treiber stack).
+// push links a new node in front of head with a CAS. pop protects the head
+// node with a hazard pointer before reading its next pointer, so the node
+// cannot be freed under it. That also rules out ABA: the CAS from head to
+// next only succeeds if head is still the same node, and a protected node
+// cannot be freed and its address reused by a later push in the meantime.
+template <typename T>
+class TreiberStack {
+private:
+    struct Node {
+        T value;
+        Node* next;
+    };
+
+    alignas(64) atomic<Node*> head;
+
+    static void deleteNode(void* ptr) { delete static_cast<Node*>(ptr); }
+
+public:
+    TreiberStack() : head(nullptr) {}
+
+    ~TreiberStack() {
+        Node* node = head.load(memory_order_relaxed);
+        while (node) {
+            Node* next = node->next;
+            delete node;
+            node = next;
+        }
+    }
+
+    TreiberStack(const TreiberStack&) = delete;
+    TreiberStack& operator=(const TreiberStack&) = delete;
+
+    bool push(const T& item) {
+        Node* node = new Node{item, head.load(memory_order_relaxed)};
+        while (!head.compare_exchange_weak(node->next, node, memory_order_release, memory_order_relaxed)) {
+        }
+        return true;
+    }
+
+    bool pop(T& out) {
+        HazardPointers& hazards = HazardPointers::instance();
+        Node* top = head.load(memory_order_acquire);
+        while (top) {
+            hazards.protect(top);
+            // Re-check after publishing: if head moved, top may already be retired
+            Node* current = head.load(memory_order_seq_cst);
+            if (current != top) {
+                top = current;
+                continue;
+            }
+            if (head.compare_exchange_strong(top, top->next)) {
+                break;
+            }
+        }
+        hazards.clear();
+        if (!top) {
+            return false;
+        }
+        out = std::move(top->value);
+        hazards.retire(top, deleteNode);
+        return true;
+    }
+
+    bool empty() const { return head.load(memory_order_acquire) == nullptr; }
+};
+
 class TextEditor {
 private:
-    static const int MAX_SIZE = 100;
-    string states[MAX_SIZE];
-    int top;
+    static const size_t DEFAULT_BUDGET = 64 << 20;
+
+    // A state of the text and, in a saved session, its offset in the journal
+    struct Version {
+        Rope text;
+        uint64_t offset = 0;
+    };
+
+    UndoRedoStack<Version> history;
+    EditJournal journal;
+    string sessionPath;
+    size_t pagedIn;  // States rebuilt from the journal because they were not in memory
+
+    Version current() const {
+        return history.hasCurrent() ? history.current() : Version{Rope(), journal.isOpen() ? journal.begin() : 0};
+    }
+
+    // Push a version derived from the current one, charging it the memory
+    // its new nodes took
+    void pushVersion(const Version& version, size_t allocatedBefore) {
+        history.push(version, sizeof(Version) + Rope::bytesAllocated() - allocatedBefore);
+    }
+
+    // Apply an edit to the current state; in a session it is appended to the
+    // journal too. If the journal cannot take it, the session is closed at
+    // the state before the edit and editing goes on in memory only.
+    void pushEdit(const EditOp& edit) {
+        size_t before = Rope::bytesAllocated();
+        Version next{current().text.apply(edit), 0};
+        if (journal.isOpen() && !journal.append(edit, next.offset)) {
+            journal.close();
+            cout << "Warning: this edit was not saved to " << sessionPath
+                 << "; the session is closed and reopening it restores the text before the edit\n";
+        }
+        pushVersion(next, before);
+    }
+
+    // Keep the journal cursor on the current state
+    void syncJournal() {
+        if (journal.isOpen()) {
+            journal.setCursor(current().offset);
+        }
+    }
 
 public:
-    TextEditor() : top(-1) {}
+    TextEditor() : history(DEFAULT_BUDGET), pagedIn(0) {}
+    ~TextEditor() { closeSession(); }
 
     // Save current text state
     void saveState(string text) {
-        if (top < MAX_SIZE - 1) {
-            states[++top] = text;
-            cout << "Saved: \"" << text << "\"\n";
-        } else {
-            cout << "Stack full, cannot save state!\n";
+        pushEdit(diffStates(current().text.toString(), text));
+        cout << "Saved: \"" << text << "\"\n";
+    }
+
+    // Insert text at a position of the current state
+    void insertText(size_t position, const string& text) {
+        Rope document = current().text;
+        if (position > document.length()) {
+            cout << "Position out of range! The text has " << document.length() << " characters.\n";
+            return;
         }
+        pushEdit({position, "", text});
+        cout << "Saved: \"" << history.current().text.toString() << "\"\n";
+    }
+
+    // Delete count characters starting at a position of the current state
+    void deleteText(size_t position, size_t count) {
+        Rope document = current().text;
+        if (position >= document.length()) {
+            cout << "Position out of range! The text has " << document.length() << " characters.\n";
+            return;
+        }
+        count = min(count, document.length() - position);
+        pushEdit({position, document.substr(position, count), ""});
+        cout << "Saved: \"" << history.current().text.toString() << "\"\n";
     }
 
     // Undo last change
     void undo() {
-        if (top == -1) {
+        bool inMemory = journal.isOpen() ? history.undoDepth() > 1 : history.canUndo();
+        if (inMemory) {
+            cout << "Restored: \"" << history.current().text.toString() << "\"\n";
+            history.undo();
+            syncJournal();
+            return;
+        }
+        if (journal.isOpen() && current().offset > journal.begin()) {
+            // Older than anything in memory: rebuild the previous state by
+            // taking back the journal record that produced this one. The
+            // states above it stay in the journal for redo.
+            Version state = current();
+            size_t before = Rope::bytesAllocated();
+            EditOp edit;
+            Version older;
+            if (!journal.recordBefore(state.offset, edit, older.offset)) {
+                cout << "Error: " << sessionPath << " is damaged; cannot undo further!\n";
+                return;
+            }
+            cout << "Restored: \"" << state.text.toString() << "\"\n";
+            older.text = state.text.revert(edit);
+            history.clear();
+            pushVersion(older, before);
+            syncJournal();
+            pagedIn++;
+            return;
+        }
+        if (!journal.isOpen() && history.evictedCount() > 0 && history.hasCurrent()) {
+            cout << "No more changes to undo (older states were evicted to stay within the memory budget)!\n";
+        } else {
             cout << "No changes to undo!\n";
+        }
+    }
+
+    // Redo the last undone change
+    void redo() {
+        if (history.canRedo()) {
+            history.redo();
+            syncJournal();
+        } else if (journal.isOpen() && current().offset < journal.end()) {
+            // Undone before this session's memory: replay the next record
+            Version state = current();
+            size_t before = Rope::bytesAllocated();
+            EditOp edit;
+            Version newer;
+            if (!journal.recordAt(state.offset, edit, newer.offset)) {
+                cout << "Error: " << sessionPath << " is damaged; cannot redo further!\n";
+                return;
+            }
+            newer.text = state.text.apply(edit);
+            pushVersion(newer, before);
+            syncJournal();
+            pagedIn++;
+        } else {
+            cout << "No changes to redo!\n";
             return;
         }
-        cout << "Restored: \"" << states[top--] << "\"\n";
+        cout << "Redone: \"" << history.current().text.toString() << "\"\n";
     }
 
     // Display current state
     void displayCurrent() {
-        if (top == -1) {
+        if (!history.hasCurrent()) {
             cout << "No text state!\n";
             return;
         }
-        cout << "Current state: \"" << states[top] << "\"\n";
+        cout << "Current state: \"" << history.current().text.toString() << "\"\n";
     }
 
-    // Display all history
+    // Display all history, including states that can be redone
     void displayHistory() {
-        if (top == -1) {
+        size_t total = history.undoDepth() + history.redoDepth();
+        if (total == 0) {
             cout << "No history available!\n";
             return;
         }
         cout << "\n===== Text History =====\n";
-        for (int i = 0; i <= top; i++) {
-            cout << i+1 << ". \"" << states[i] << "\"";
-            if (i == top) {
+        if (journal.isOpen() && history.at(0).offset > journal.begin()) {
+            cout << "(older states are in the session journal and are loaded on undo)\n";
+        } else if (history.evictedCount() > 0) {
+            cout << "(" << history.evictedCount() << " older states evicted)\n";
+        }
+        for (size_t i = 0; i < total; i++) {
+            cout << i+1 << ". \"" << history.at(i).text.toString() << "\"";
+            if (i + 1 == history.undoDepth()) {
                 cout << " (current)";
+            } else if (i >= history.undoDepth()) {
+                cout << " (undone, can redo)";
             }
             cout << "\n";
         }
         cout << "======================\n\n";
     }
+
+    // Memory held by the undo history vs one full copy per state
+    void displayMemoryUsage() {
+        size_t total = history.undoDepth() + history.redoDepth();
+        vector<Rope> versions;
+        size_t snapshotBytes = 0;
+        for (size_t i = 0; i < total; i++) {
+            versions.push_back(history.at(i).text);
+            snapshotBytes += sizeof(string) + versions.back().length();
+        }
+        cout << "States kept: " << total << " (" << history.redoDepth() << " can be redone, "
+             << history.evictedCount() << " evicted)\n";
+        cout << "Rope versions (shared nodes counted once): " << Rope::memoryUsage(versions) << " bytes\n";
+        cout << "Charged against budget: " << history.memoryUsed() << " of " << history.memoryBudget()
+             << " bytes\n";
+        cout << "Full snapshots would use: " << snapshotBytes << " bytes\n";
+        if (journal.isOpen()) {
+            cout << "Session journal " << sessionPath << ": " << journal.end() - journal.begin()
+                 << " bytes of edits, " << pagedIn << " states loaded from it\n";
+        }
+    }
+
+    // Change the history memory budget, evicting old states if needed
+    void setMemoryBudget(size_t kilobytes) {
+        history.setBudget(kilobytes * 1024);
+        cout << "History memory budget set to " << kilobytes << " KB\n";
+    }
+
+    // Continue a saved session (or start a new one) from a journal file.
+    // Only the current text is loaded; older states are read from the
+    // journal when undo reaches them.
+    void openSession(const string& path) {
+        closeSession();
+        Rope text;
+        size_t replayed;
+        if (!journal.open(path, text, replayed)) {
+            journal.close();
+            return;
+        }
+        sessionPath = path;
+        pagedIn = 0;
+        history.clear();
+        if (journal.cursor() > journal.begin()) {
+            size_t before = Rope::bytesAllocated();
+            pushVersion({text, journal.cursor()}, before);
+        }
+        cout << "Opened session " << path << ": " << text.length() << " characters";
+        if (replayed > 0) {
+            cout << " (" << replayed << " edits replayed since the last snapshot)";
+        }
+        cout << "\n";
+    }
+
+    // Snapshot the current text and close the session journal
+    void closeSession() {
+        if (!journal.isOpen()) {
+            return;
+        }
+        journal.writeSnapshot(current().text);
+        journal.close();
+        cout << "Session saved to " << sessionPath << "\n";
+    }
+};
+
+// Seconds elapsed since a start time
+double secondsSince(chrono::steady_clock::time_point start) {
+    return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+// A 1 MB document edited 100 times with small inserts, deletes and
+// replacements: one string per state vs the delta history
+void runHistoryBenchmark() {
+    const size_t DOCUMENT_SIZE = 1 << 20;
+    const int EDITS = 100;
+
+    mt19937 rng(42);
+    string document(DOCUMENT_SIZE, ' ');
+    for (char& c : document) {
+        c = 'a' + rng() % 26;
+    }
+    vector<string> states;
+    vector<EditOp> edits;
+    states.push_back(document);
+    for (int i = 1; i < EDITS; i++) {
+        size_t position = rng() % document.size();
+        size_t removed = min<size_t>(rng() % 64, document.size() - position);
+        string inserted(rng() % 64, 'a' + rng() % 26);
+        edits.push_back({position, document.substr(position, removed), inserted});
+        document.replace(position, removed, inserted);
+        states.push_back(document);
+    }
+
+    cout << "\n===== Undo History: 1 MB document, " << EDITS << " edits =====\n";
+    cout << left << setw(32) << "History" << right << setw(12) << "Memory MB" << setw(12) << "Save ms"
+         << setw(14) << "Undo all ms" << "\n" << left;
+
+    {
+        auto start = chrono::steady_clock::now();
+        vector<string> snapshots;
+        size_t bytes = 0;
+        for (const string& state : states) {
+            snapshots.push_back(state);
+            bytes += sizeof(string) + snapshots.back().capacity();
+        }
+        double saveSeconds = secondsSince(start);
+        start = chrono::steady_clock::now();
+        size_t checksum = 0;
+        while (!snapshots.empty()) {
+            checksum += snapshots.back().size();
+            snapshots.pop_back();
+        }
+        double undoSeconds = secondsSince(start);
+        cout << setw(32) << "Full snapshot per state" << right << fixed << setprecision(2) << setw(12)
+             << bytes / 1048576.0 << setw(12) << saveSeconds * 1000 << setw(14) << undoSeconds * 1000 << "\n"
+             << left;
+    }
+
+    for (size_t interval : {16, 64}) {
+        DeltaHistory history(interval);
+        auto start = chrono::steady_clock::now();
+        for (const string& state : states) {
+            history.push(state);
+        }
+        double saveSeconds = secondsSince(start);
+        size_t bytes = history.memoryUsage();
+
+        // Random access is bounded by the checkpoint interval
+        bool matches = history.stateAt(EDITS / 2 + 3) == states[EDITS / 2 + 3];
+
+        start = chrono::steady_clock::now();
+        while (history.size() > 1) {
+            history.pop();
+        }
+        double undoSeconds = secondsSince(start);
+        matches = matches && history.currentState() == states[0];
+        cout << setw(32) << "Delta, checkpoint every " + to_string(interval) << right << setw(12)
+             << bytes / 1048576.0 << setw(12) << saveSeconds * 1000 << setw(14) << undoSeconds * 1000
+             << (matches ? "" : "  MISMATCH") << "\n" << left;
+    }
+
+    {
+        auto start = chrono::steady_clock::now();
+        vector<Rope> versions;
+        versions.push_back(Rope(states[0]));
+        for (const EditOp& edit : edits) {
+            versions.push_back(versions.back().apply(edit));
+        }
+        double saveSeconds = secondsSince(start);
+        size_t bytes = Rope::memoryUsage(versions);
+        bool matches = versions[EDITS / 2 + 3].toString() == states[EDITS / 2 + 3];
+
+        start = chrono::steady_clock::now();
+        while (versions.size() > 1) {
+            versions.pop_back();
+        }
+        double undoSeconds = secondsSince(start);
+        cout << setw(32) << "Rope versions (shared nodes)" << right << setw(12) << bytes / 1048576.0 << setw(12)
+             << saveSeconds * 1000 << setw(14) << undoSeconds * 1000 << (matches ? "" : "  MISMATCH") << "\n"
+             << left;
+    }
+}
+
+// Random inserts and deletes on multi-megabyte documents: one std::string
+// edited in place (no history at all) vs the rope keeping every version
+void runDocumentBenchmark() {
+    const int EDITS = 5000;
+
+    cout << "\n===== Editing large documents (" << EDITS << " random inserts/deletes) =====\n";
+    cout << left << setw(12) << "Document" << setw(30) << "Model" << right << setw(12) << "us/edit" << setw(14)
+         << "Memory MB" << "\n" << left;
+
+    for (size_t megabytes : {1, 4, 16}) {
+        mt19937 rng(megabytes);
+        string text(megabytes << 20, ' ');
+        for (char& c : text) {
+            c = 'a' + rng() % 26;
+        }
+        vector<EditOp> edits;
+        size_t length = text.size();
+        for (int i = 0; i < EDITS; i++) {
+            size_t position = rng() % length;
+            if (rng() % 2) {
+                edits.push_back({position, "", string(1 + rng() % 32, 'x')});
+                length += edits.back().inserted.size();
+            } else {
+                size_t count = min<size_t>(1 + rng() % 32, length - position);
+                edits.push_back({position, string(count, '?'), ""});
+                length -= count;
+            }
+        }
+        string label = to_string(megabytes) + " MB";
+
+        {
+            string document = text;
+            auto start = chrono::steady_clock::now();
+            for (const EditOp& edit : edits) {
+                document.replace(edit.position, edit.removed.size(), edit.inserted);
+            }
+            double seconds = secondsSince(start);
+            cout << setw(12) << label << setw(30) << "std::string, no history" << right << fixed
+                 << setprecision(2) << setw(12) << seconds * 1e6 / EDITS << setw(14)
+                 << document.capacity() / 1048576.0 << "\n" << left;
+        }
+        {
+            vector<Rope> versions;
+            versions.push_back(Rope(text));
+            auto start = chrono::steady_clock::now();
+            for (const EditOp& edit : edits) {
+                versions.push_back(versions.back().apply(edit));
+            }
+            double seconds = secondsSince(start);
+            cout << setw(12) << label << setw(30) << "Rope, all versions kept" << right << setw(12)
+                 << seconds * 1e6 / EDITS << setw(14) << Rope::memoryUsage(versions) / 1048576.0 << "\n" << left;
+        }
+    }
+}
+
+// Long editing session on a 1 MB document with a memory budget: pushes,
+// evictions and undo/redo walks on the undo/redo stack
+void runUndoStackBenchmark() {
+    const int EDITS = 50000;
+    const size_t BUDGET = 16 << 20;
+
+    mt19937 rng(9);
+    string text(1 << 20, ' ');
+    for (char& c : text) {
+        c = 'a' + rng() % 26;
+    }
+
+    UndoRedoStack<Rope> history(BUDGET);
+    history.push(Rope(text), text.size());
+    size_t length = text.size();
+    auto start = chrono::steady_clock::now();
+    for (int i = 0; i < EDITS; i++) {
+        size_t before = Rope::bytesAllocated();
+        size_t position = rng() % length;
+        Rope next = rng() % 2 ? history.current().insert(position, string(1 + rng() % 16, 'x'))
+                              : history.current().erase(position, 1 + rng() % 16);
+        length = next.length();
+        history.push(next, sizeof(Rope) + Rope::bytesAllocated() - before);
+    }
+    double pushSeconds = secondsSince(start);
+
+    start = chrono::steady_clock::now();
+    size_t moves = 0;
+    while (history.canUndo()) {
+        history.undo();
+        moves++;
+    }
+    while (history.canRedo()) {
+        history.redo();
+        moves++;
+    }
+    double walkSeconds = secondsSince(start);
+
+    cout << "\n===== Undo/redo stack: " << EDITS << " edits of a 1 MB document, " << (BUDGET >> 20)
+         << " MB budget =====\n";
+    cout << fixed << setprecision(2);
+    cout << "Edit + push: " << pushSeconds * 1e6 / EDITS << " us per edit\n";
+    cout << "States kept: " << history.undoDepth() << ", evicted: " << history.evictedCount()
+         << ", charged: " << history.memoryUsed() / 1048576.0 << " MB\n";
+    cout << "Undo to oldest kept state and redo back: " << moves << " moves in " << walkSeconds * 1e6 << " us\n";
+}
+
+// Sessions of growing length on a 1 MB document saved to the edit journal:
+// append cost, reopening from the snapshot vs replaying the whole journal,
+// and undoing past the start of the reopened session
+void runJournalBenchmark() {
+    const int UNDOS = 1000;
+
+    char pattern[] = "/tmp/editjournal_benchXXXXXX";
+    if (mkdtemp(pattern) == nullptr) {
+        cout << "Error: cannot create a benchmark directory: " << strerror(errno) << "\n";
+        return;
+    }
+    string path = string(pattern) + "/session.journal";
+
+    cout << "\n===== Session journal: 1 MB document =====\n";
+    cout << left << setw(10) << "Edits" << right << setw(14) << "Append us" << setw(14) << "Journal MB"
+         << setw(14) << "Reopen ms" << setw(18) << "Full replay ms" << setw(16) << "Undo us/state" << "\n"
+         << left;
+
+    for (int edits : {1000, 10000, 100000}) {
+        mt19937 rng(edits);
+        string text(1 << 20, ' ');
+        for (char& c : text) {
+            c = 'a' + rng() % 26;
+        }
+        EditJournal::remove(path);
+
+        // Record the session: the initial document, then small random edits
+        Rope document;
+        size_t replayed;
+        double appendSeconds = 0;
+        {
+            EditJournal journal;
+            if (!journal.open(path, document, replayed)) {
+                break;
+            }
+            EditOp first{0, "", text};
+            uint64_t offset;
+            if (!journal.append(first, offset)) {
+                break;
+            }
+            document = document.apply(first);
+            for (int i = 0; i < edits; i++) {
+                size_t position = rng() % document.length();
+                EditOp edit;
+                if (rng() % 2) {
+                    edit = {position, "", string(1 + rng() % 16, 'a' + rng() % 26)};
+                } else {
+                    edit = {position, document.substr(position, 1 + rng() % 16), ""};
+                }
+                auto start = chrono::steady_clock::now();
+                bool appended = journal.append(edit, offset);
+                appendSeconds += secondsSince(start);
+                if (!appended) {
+                    break;
+                }
+                document = document.apply(edit);
+            }
+            journal.writeSnapshot(document);
+        }
+        double journalMegabytes = 0;
+        struct stat info;
+        if (stat(path.c_str(), &info) == 0) {
+            journalMegabytes = info.st_size / 1048576.0;
+        }
+
+        // Reopen from the snapshot, then walk back past it through the journal
+        Rope reopened;
+        auto start = chrono::steady_clock::now();
+        EditJournal journal;
+        journal.open(path, reopened, replayed);
+        double reopenSeconds = secondsSince(start);
+        bool matches = reopened.length() == document.length();
+
+        start = chrono::steady_clock::now();
+        uint64_t offset = journal.cursor();
+        EditOp edit;
+        for (int i = 0; i < UNDOS && journal.recordBefore(offset, edit, offset); i++) {
+            reopened = reopened.revert(edit);
+        }
+        double undoSeconds = secondsSince(start);
+        journal.close();
+
+        // Without a snapshot every record has to be replayed
+        unlink((path + ".snapshot").c_str());
+        Rope replayedText;
+        start = chrono::steady_clock::now();
+        EditJournal fullJournal;
+        fullJournal.open(path, replayedText, replayed);
+        double replaySeconds = secondsSince(start);
+        fullJournal.close();
+        matches = matches && replayedText.toString() == document.toString();
+
+        cout << setw(10) << edits << right << fixed << setprecision(2) << setw(14) << appendSeconds * 1e6 / edits
+             << setw(14) << journalMegabytes << setw(14) << reopenSeconds * 1000 << setw(18)
+             << replaySeconds * 1000 << setw(16) << undoSeconds * 1e6 / UNDOS << (matches ? "" : "  MISMATCH")
+             << "\n" << left;
+    }
+    EditJournal::remove(path);
+    rmdir(pattern);
+}
+
+// Mutex around a growable stack, the baseline for the concurrent benchmark
+template <typename T>
+class LockedStack {
+private:
+    mutex lock;
+    GrowableStack<T> items;
+
+public:
+    bool push(const T& item) {
+        lock_guard<mutex> guard(lock);
+        return items.push(item);
+    }
+
+    bool pop(T& out) {
+        lock_guard<mutex> guard(lock);
+        return items.pop(out);
+    }
 };
 
+// Each thread pushes a burst of BURST items and pops as many, perThread
+// times over; returns the elapsed seconds
+template <typename Stack>
+double runStackThreads(Stack& stack, int threads, int perThread) {
+    const int BURST = 4;
+    atomic<bool> go(false);
+    atomic<int> ready(0);
+    vector<thread> workers;
+    for (int t = 0; t < threads; t++) {
+        workers.emplace_back([&stack, &go, &ready, perThread, t]() {
+            ready++;
+            while (!go.load(memory_order_acquire)) {
+                this_thread::yield();
+            }
+            int item;
+            for (int i = 0; i < perThread; i += BURST) {
+                for (int j = 0; j < BURST; j++) {
+                    stack.push(t);
+                }
+                for (int j = 0; j < BURST; j++) {
+                    stack.pop(item);
+                }
+            }
+        });
+    }
+    while (ready.load() < threads) {
+        this_thread::yield();
+    }
+    auto start = chrono::steady_clock::now();
+    go.store(true, memory_order_release);
+    for (thread& worker : workers) {
+        worker.join();
+    }
+    return secondsSince(start);
+}
+
+// Push/pop throughput of the generic stacks: the array stacks on one thread,
+// then the Treiber stack against a mutex-guarded stack at 1-32 threads.
+// Every thread count does the same total work.
+void runStackBenchmark() {
+    const int TOTAL = 1 << 21;
+
+    cout << "\n===== Generic stacks: " << TOTAL << " pushes and pops =====\n";
+    cout << left << setw(28) << "Stack" << right << setw(8) << "Threads" << setw(12) << "ms" << setw(12)
+         << "Mops/s" << "\n" << left;
+    auto printRow = [](const string& name, int threads, double seconds) {
+        cout << setw(28) << name << right << setw(8) << threads << fixed << setprecision(2) << setw(12)
+             << seconds * 1000 << setw(12) << 2.0 * TOTAL / seconds / 1e6 << "\n" << left;
+    };
+
+    {
+        FixedStack<int, 64> stack;
+        printRow("FixedStack<int, 64>", 1, runStackThreads(stack, 1, TOTAL));
+    }
+    {
+        GrowableStack<int> stack;
+        printRow("GrowableStack<int>", 1, runStackThreads(stack, 1, TOTAL));
+    }
+    for (int threads = 1; threads <= 32; threads *= 2) {
+        {
+            LockedStack<int> stack;
+            printRow("Mutex + GrowableStack", threads, runStackThreads(stack, threads, TOTAL / threads));
+        }
+        {
+            TreiberStack<int> stack;
+            printRow("TreiberStack (lock-free)", threads, runStackThreads(stack, threads, TOTAL / threads));
+        }
+    }
+}
+
+// Run all text editor benchmarks
+void runBenchmarks() {
+    runHistoryBenchmark();
+    runDocumentBenchmark();
+    runUndoStackBenchmark();
+    runJournalBenchmark();
+    runStackBenchmark();
+    cout << "=====================================\n";
+}
+
 // Display menu
 void displayMenu() {
     cout << "\n===== Text Editor Menu =====\n";
@@ -66,8 +1665,15 @@ void displayMenu() {
     cout << "2. Undo\n";
     cout << "3. Display current text\n";
     cout << "4. Display history\n";
-    cout << "5. Exit\n";
-    cout << "Enter your choice (1-5): ";
+    cout << "5. Insert text at position\n";
+    cout << "6. Delete text at position\n";
+    cout << "7. Redo\n";
+    cout << "8. Show history memory usage\n";
+    cout << "9. Set history memory budget\n";
+    cout << "10. Run benchmarks\n";
+    cout << "11. Open saved session\n";
+    cout << "12. Exit\n";
+    cout << "Enter your choice (1-12): ";
 }
 
 void clearInputBuffer() {
@@ -78,6 +1684,7 @@ void clearInputBuffer() {
 int main() {
     TextEditor editor;
     int choice;
+    size_t position, count;
     string text;
     bool running = true;
 
@@ -114,12 +1721,71 @@ int main() {
                 break;
 
             case 5:
+                cout << "Enter position (0 = start): ";
+                if (!(cin >> position)) {
+                    cout << "Invalid position. Please enter a number.\n";
+                    clearInputBuffer();
+                    break;
+                }
+                clearInputBuffer();
+                cout << "Enter text: ";
+                getline(cin, text);
+                editor.insertText(position, text);
+                break;
+
+            case 6:
+                cout << "Enter position (0 = start): ";
+                if (!(cin >> position)) {
+                    cout << "Invalid position. Please enter a number.\n";
+                    clearInputBuffer();
+                    break;
+                }
+                cout << "Enter number of characters to delete: ";
+                if (!(cin >> count)) {
+                    cout << "Invalid number. Please enter a number.\n";
+                    clearInputBuffer();
+                    break;
+                }
+                clearInputBuffer();
+                editor.deleteText(position, count);
+                break;
+
+            case 7:
+                editor.redo();
+                break;
+
+            case 8:
+                editor.displayMemoryUsage();
+                break;
+
+            case 9:
+                cout << "Enter budget in KB: ";
+                if (!(cin >> count) || count == 0) {
+                    cout << "Invalid budget. Please enter a positive number.\n";
+                    clearInputBuffer();
+                    break;
+                }
+                clearInputBuffer();
+                editor.setMemoryBudget(count);
+                break;
+
+            case 10:
+                runBenchmarks();
+                break;
+
+            case 11:
+                cout << "Enter session file: ";
+                getline(cin, text);
+                editor.openSession(text);
+                break;
+
+            case 12:
                 cout << "Exiting Text Editor. Goodbye!\n";
                 running = false;
                 break;
 
             default:
-                cout << "Invalid choice. Please enter a number between 1 and 5.\n";
+                cout << "Invalid choice. Please enter a number between 1 and 12.\n";
         }
     }
 
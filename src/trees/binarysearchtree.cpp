@@ -2,6 +2,24 @@
 #include <string>
 #include <iomanip>
 #include <limits>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <iterator>
+#include <algorithm>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <condition_variable>
+#include <cstring>
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 
 using namespace std;
 
@@ -10,26 +28,146 @@ struct Book {
     string title;
     string author;
     int year;
+    int size;  // Number of books in this subtree, including this one
     Book* left;
     Book* right;
+    Book* parent;
 
-    Book(int i, string t, string a, int y) : id(i), title(t), author(a), year(y), left(nullptr), right(nullptr) {}
+    Book(int i, string t, string a, int y)
+        : id(i), title(t), author(a), year(y), size(1), left(nullptr), right(nullptr), parent(nullptr) {}
 };
 
-// Book Catalog class implemented as a Binary Search Tree
+// Step to the next/previous book in ID order using parent pointers
+Book* inOrderSuccessor(Book* node) {
+    if (node->right != nullptr) {
+        node = node->right;
+        while (node->left != nullptr) {
+            node = node->left;
+        }
+        return node;
+    }
+    while (node->parent != nullptr && node == node->parent->right) {
+        node = node->parent;
+    }
+    return node->parent;
+}
+
+Book* inOrderPredecessor(Book* node) {
+    if (node->left != nullptr) {
+        node = node->left;
+        while (node->right != nullptr) {
+            node = node->right;
+        }
+        return node;
+    }
+    while (node->parent != nullptr && node == node->parent->left) {
+        node = node->parent;
+    }
+    return node->parent;
+}
+
+// Step to the next book in pre-order (node, left, right)
+Book* preOrderSuccessor(Book* node) {
+    if (node->left != nullptr) {
+        return node->left;
+    }
+    if (node->right != nullptr) {
+        return node->right;
+    }
+    while (node->parent != nullptr) {
+        Book* parent = node->parent;
+        if (node == parent->left && parent->right != nullptr) {
+            return parent->right;
+        }
+        node = parent;
+    }
+    return nullptr;
+}
+
+// STL-style forward iterator over books; Step picks the traversal order.
+// Iterators hold a single pointer, so walking the catalog needs no recursion
+// and no extra memory. Any change to the catalog invalidates them.
+template <Book* (*Step)(Book*)>
+class BookIterator {
+private:
+    Book* node;
+
+public:
+    using iterator_category = forward_iterator_tag;
+    using value_type = Book;
+    using difference_type = ptrdiff_t;
+    using pointer = const Book*;
+    using reference = const Book&;
+
+    explicit BookIterator(Book* n = nullptr) : node(n) {}
+
+    reference operator*() const { return *node; }
+    pointer operator->() const { return node; }
+    BookIterator& operator++() {
+        node = Step(node);
+        return *this;
+    }
+    BookIterator operator++(int) {
+        BookIterator old = *this;
+        node = Step(node);
+        return old;
+    }
+    bool operator==(const BookIterator& other) const { return node == other.node; }
+    bool operator!=(const BookIterator& other) const { return node != other.node; }
+};
+
+// Book Catalog class implemented as a Binary Search Tree.
+// The tree is weight-balanced on its subtree counts, which keeps it O(log n)
+// deep and lets it answer order-statistic queries (k-th book, rank of an ID).
 class BookCatalog {
 private:
     Book* root;
 
+    // Weight-balance parameters (Adams' trees with Hirai-Yamamoto's <3,2>)
+    static const int DELTA = 3;
+    static const int RATIO = 2;
+
     Book* insertBook(Book* node, int id, string title, string author, int year);
-    void displayInOrder(Book* node);
-    void displayPreOrder(Book* node);
     Book* findBook(Book* node, int id);
     Book* removeBook(Book* node, int id);
     Book* findMinValueNode(Book* node);
     void destroyTree(Book* node);
 
+    static int subtreeSize(Book* node) { return node ? node->size : 0; }
+    static int weight(Book* node) { return subtreeSize(node) + 1; }
+    static void updateSize(Book* node) { node->size = subtreeSize(node->left) + subtreeSize(node->right) + 1; }
+    static void setParent(Book* child, Book* parent) {
+        if (child != nullptr) {
+            child->parent = parent;
+        }
+    }
+    Book* rotateLeft(Book* node);
+    Book* rotateRight(Book* node);
+    Book* balance(Book* node);
+    Book* selectNode(int k);
+    Book* minNode() { return root ? findMinValueNode(root) : nullptr; }
+    Book* maxNode();
+
 public:
+    typedef BookIterator<inOrderSuccessor> iterator;
+    typedef BookIterator<inOrderPredecessor> reverse_iterator;
+    typedef BookIterator<preOrderSuccessor> preorder_iterator;
+
+    // Forward cursor over a range of books in ID order. It is invalidated by
+    // any change to the catalog.
+    class Cursor {
+    private:
+        iterator position;
+        int remaining;
+
+        friend class BookCatalog;
+
+    public:
+        Cursor() : remaining(0) {}
+        bool hasNext() const { return remaining > 0 && position != iterator(); }
+        const Book* next();
+    };
+
     BookCatalog() : root(nullptr) {}
     ~BookCatalog() { destroyTree(root); }
 
@@ -39,11 +177,60 @@ public:
     bool searchBook(int id);
     void deleteBook(int id);
     void displayBook(int id);
+
+    int size() const { return subtreeSize(root); }
+    const Book* select(int k);
+    int rank(int id);
+    Cursor iterateFrom(int k, int count);
+    void displayPage(int k, int count);
+
+    iterator begin() { return iterator(minNode()); }
+    iterator end() { return iterator(); }
+    reverse_iterator rbegin() { return reverse_iterator(maxNode()); }
+    reverse_iterator rend() { return reverse_iterator(); }
+    preorder_iterator preorderBegin() { return preorder_iterator(root); }
+    preorder_iterator preorderEnd() { return preorder_iterator(); }
+
+    template <typename Visitor> void forEachMorris(Visitor visit);
+    void exportCSV(ostream& out);
 };
 
+// In-order walk by Morris threading: O(1) extra memory without parent
+// pointers. It temporarily rewires right pointers, so the visitor must not
+// touch the catalog and no other thread may read it during the walk.
+template <typename Visitor>
+void BookCatalog::forEachMorris(Visitor visit) {
+    Book* current = root;
+    while (current != nullptr) {
+        if (current->left == nullptr) {
+            visit(static_cast<const Book&>(*current));
+            current = current->right;
+            continue;
+        }
+        Book* predecessor = current->left;
+        while (predecessor->right != nullptr && predecessor->right != current) {
+            predecessor = predecessor->right;
+        }
+        if (predecessor->right == nullptr) {
+            predecessor->right = current;  // Thread back to the ancestor
+            current = current->left;
+        } else {
+            predecessor->right = nullptr;  // Remove the thread again
+            visit(static_cast<const Book&>(*current));
+            current = current->right;
+        }
+    }
+}
+
+// Print a single catalog row
+void printBookRow(const Book* book) {
+    cout << left << setw(6) << book->id << setw(30) << book->title << setw(20) << book->author << book->year << endl;
+}
+
 // Add a book to the catalog
 void BookCatalog::addBook(int id, string title, string author, int year) {
     root = insertBook(root, id, title, author, year);
+    root->parent = nullptr;
     cout << "Book added: " << title << " by " << author << " (ID: " << id << ")\n";
 }
 
@@ -55,12 +242,65 @@ Book* BookCatalog::insertBook(Book* node, int id, string title, string author, i
 
     if (id < node->id) {
         node->left = insertBook(node->left, id, title, author, year);
+        node->left->parent = node;
     } else if (id > node->id) {
         node->right = insertBook(node->right, id, title, author, year);
+        node->right->parent = node;
     } else {
         cout << "Error: Book with ID " << id << " already exists!\n";
+        return node;
     }
 
+    return balance(node);
+}
+
+// Rotate the right child up, keeping subtree counts correct
+Book* BookCatalog::rotateLeft(Book* node) {
+    Book* pivot = node->right;
+    node->right = pivot->left;
+    setParent(node->right, node);
+    pivot->left = node;
+    pivot->parent = node->parent;
+    node->parent = pivot;
+    updateSize(node);
+    updateSize(pivot);
+    return pivot;
+}
+
+// Rotate the left child up, keeping subtree counts correct
+Book* BookCatalog::rotateRight(Book* node) {
+    Book* pivot = node->left;
+    node->left = pivot->right;
+    setParent(node->left, node);
+    pivot->right = node;
+    pivot->parent = node->parent;
+    node->parent = pivot;
+    updateSize(node);
+    updateSize(pivot);
+    return pivot;
+}
+
+// Restore the weight balance of a node after one insert or delete below it
+Book* BookCatalog::balance(Book* node) {
+    int leftWeight = weight(node->left);
+    int rightWeight = weight(node->right);
+
+    if (rightWeight > DELTA * leftWeight) {
+        Book* r = node->right;
+        if (weight(r->left) >= RATIO * weight(r->right)) {
+            node->right = rotateRight(r);
+        }
+        return rotateLeft(node);
+    }
+    if (leftWeight > DELTA * rightWeight) {
+        Book* l = node->left;
+        if (weight(l->right) >= RATIO * weight(l->left)) {
+            node->left = rotateLeft(l);
+        }
+        return rotateRight(node);
+    }
+
+    updateSize(node);
     return node;
 }
 
@@ -72,20 +312,13 @@ void BookCatalog::displayAllBooks() {
     } else {
         cout << left << setw(6) << "ID" << setw(30) << "Title" << setw(20) << "Author" << "Year\n";
         cout << string(60, '-') << endl;
-        displayInOrder(root);
+        for (const Book& book : *this) {
+            printBookRow(&book);
+        }
     }
     cout << "===================================\n\n";
 }
 
-// Recursive helper for in-order traversal
-void BookCatalog::displayInOrder(Book* node) {
-    if (node != nullptr) {
-        displayInOrder(node->left);
-        cout << left << setw(6) << node->id << setw(30) << node->title << setw(20) << node->author << node->year << endl;
-        displayInOrder(node->right);
-    }
-}
-
 // Display all books in pre-order (root, left, right)
 void BookCatalog::displayAllBooksPreOrder() {
     cout << "\n===== Book Catalog (Pre-Order) =====\n";
@@ -94,20 +327,13 @@ void BookCatalog::displayAllBooksPreOrder() {
     } else {
         cout << left << setw(6) << "ID" << setw(30) << "Title" << setw(20) << "Author" << "Year\n";
         cout << string(60, '-') << endl;
-        displayPreOrder(root);
+        for (preorder_iterator it = preorderBegin(); it != preorderEnd(); ++it) {
+            printBookRow(&*it);
+        }
     }
     cout << "===================================\n\n";
 }
 
-// Recursive helper for pre-order traversal
-void BookCatalog::displayPreOrder(Book* node) {
-    if (node != nullptr) {
-        cout << left << setw(6) << node->id << setw(30) << node->title << setw(20) << node->author << node->year << endl;
-        displayPreOrder(node->left);
-        displayPreOrder(node->right);
-    }
-}
-
 bool BookCatalog::searchBook(int id) {
     Book* result = findBook(root, id);
     return (result != nullptr);
@@ -150,6 +376,7 @@ void BookCatalog::deleteBook(int id) {
     }
 
     root = removeBook(root, id);
+    setParent(root, nullptr);
     cout << "Book with ID " << id << " has been removed from catalog.\n";
 }
 
@@ -162,8 +389,10 @@ Book* BookCatalog::removeBook(Book* node, int id) {
     // Navigate to the node to delete
     if (id < node->id) {
         node->left = removeBook(node->left, id);
+        setParent(node->left, node);
     } else if (id > node->id) {
         node->right = removeBook(node->right, id);
+        setParent(node->right, node);
     } else {
         // Node with only one child or no child
         if (node->left == nullptr) {
@@ -183,9 +412,10 @@ Book* BookCatalog::removeBook(Book* node, int id) {
         node->author = temp->author;
         node->year = temp->year;
         node->right = removeBook(node->right, temp->id);
+        setParent(node->right, node);
     }
 
-    return node;
+    return balance(node);
 }
 
 Book* BookCatalog::findMinValueNode(Book* node) {
@@ -205,121 +435,2037 @@ void BookCatalog::destroyTree(Book* node) {
     }
 }
 
-// Clear the input buffer
-void clearInputBuffer() {
-    cin.clear();
-    cin.ignore(numeric_limits<streamsize>::max(), '\n');
+Book* BookCatalog::maxNode() {
+    Book* current = root;
+    while (current && current->right != nullptr) {
+        current = current->right;
+    }
+    return current;
 }
 
-// Display menu
-void displayMenu() {
-    cout << "\n===== Book Catalog Menu =====\n";
-    cout << "1. Add new book\n";
-    cout << "2. Display all books (in-order)\n";
-    cout << "3. Display all books (pre-order)\n";
-    cout << "4. Search for a book\n";
-    cout << "5. Remove a book\n";
-    cout << "6. Exit\n";
-    cout << "Enter your choice (1-6): ";
+// Find the k-th book in ID order (0-based), or nullptr if out of range
+const Book* BookCatalog::select(int k) {
+    return selectNode(k);
 }
 
-int main() {
-    BookCatalog catalog;
-    int choice, id, year;
-    string title, author;
-    bool running = true;
+Book* BookCatalog::selectNode(int k) {
+    if (k < 0 || k >= size()) {
+        return nullptr;
+    }
+    Book* node = root;
+    while (node != nullptr) {
+        int leftSize = subtreeSize(node->left);
+        if (k < leftSize) {
+            node = node->left;
+        } else if (k == leftSize) {
+            return node;
+        } else {
+            k -= leftSize + 1;
+            node = node->right;
+        }
+    }
+    return nullptr;
+}
 
-    cout << "Welcome to the Book Catalog (Binary Search Tree Implementation)!\n";
-    cout << "Books are organized by their unique ID numbers.\n";
+// Count the books whose ID is smaller than the given one
+int BookCatalog::rank(int id) {
+    int count = 0;
+    Book* node = root;
+    while (node != nullptr) {
+        if (id <= node->id) {
+            node = node->left;
+        } else {
+            count += subtreeSize(node->left) + 1;
+            node = node->right;
+        }
+    }
+    return count;
+}
 
-    // Add some sample books
-    catalog.addBook(1003, "To Kill a Mockingbird", "Harper Lee", 1960);
-    catalog.addBook(1001, "1984", "George Orwell", 1949);
-    catalog.addBook(1005, "The Great Gatsby", "F. Scott Fitzgerald", 1925);
-    catalog.addBook(1002, "Pride and Prejudice", "Jane Austen", 1813);
-    catalog.addBook(1004, "The Catcher in the Rye", "J.D. Salinger", 1951);
+// Position a cursor on the k-th book; it yields at most count books.
+// Seeking costs O(log n) and every step after that is amortized O(1).
+BookCatalog::Cursor BookCatalog::iterateFrom(int k, int count) {
+    Cursor cursor;
+    if (count > 0) {
+        cursor.position = iterator(selectNode(k));
+        cursor.remaining = count;
+    }
+    return cursor;
+}
 
-    while (running) {
-        displayMenu();
+// Advance to the next book in ID order
+const Book* BookCatalog::Cursor::next() {
+    if (!hasNext()) {
+        return nullptr;
+    }
+    remaining--;
+    return &*position++;
+}
 
-        if (!(cin >> choice)) {
-            cout << "Invalid input. Please enter a number.\n";
-            clearInputBuffer();
-            continue;
+// Write one CSV field, quoting it only when needed
+static void writeCSVField(ostream& out, const string& field) {
+    if (field.find_first_of(",\"\n") == string::npos) {
+        out << field;
+        return;
+    }
+    out << '"';
+    for (char c : field) {
+        if (c == '"') {
+            out << '"';
         }
-        clearInputBuffer();
+        out << c;
+    }
+    out << '"';
+}
 
-        switch (choice) {
-            case 1:
-                cout << "Enter book ID: ";
-                if (!(cin >> id)) {
-                    cout << "Invalid ID. Please enter a number.\n";
-                    clearInputBuffer();
-                    break;
-                }
-                clearInputBuffer();
+// Stream the whole catalog as CSV in ID order
+void BookCatalog::exportCSV(ostream& out) {
+    out << "id,title,author,year\n";
+    for (const Book& book : *this) {
+        out << book.id << ',';
+        writeCSVField(out, book.title);
+        out << ',';
+        writeCSVField(out, book.author);
+        out << ',' << book.year << '\n';
+    }
+}
 
-                cout << "Enter book title: ";
-                getline(cin, title);
+// Display count books starting at position k in ID order
+void BookCatalog::displayPage(int k, int count) {
+    if (k < 0 || k >= size()) {
+        cout << "Position " << k + 1 << " is out of range (catalog has " << size() << " books).\n";
+        return;
+    }
+    cout << "\n===== Books " << k + 1 << "-" << min(k + count, size()) << " of " << size() << " =====\n";
+    cout << left << setw(6) << "ID" << setw(30) << "Title" << setw(20) << "Author" << "Year\n";
+    cout << string(60, '-') << endl;
+    Cursor cursor = iterateFrom(k, count);
+    while (cursor.hasNext()) {
+        printBookRow(cursor.next());
+    }
+    cout << "===================================\n\n";
+}
 
-                cout << "Enter book author: ";
-                getline(cin, author);
+// Epoch-based reclamation shared by the concurrent catalogs. Readers announce
+// the global epoch while they hold node pointers; a retired node is only freed
+// once the global epoch has moved two steps past the epoch it was retired in,
+// which guarantees no reader can still be looking at it.
+class EpochManager {
+private:
+    static const int MAX_THREADS = 128;
+    static const uint64_t IDLE = ~0ULL;
 
-                cout << "Enter publication year: ";
-                if (!(cin >> year)) {
-                    cout << "Invalid year. Using current year.\n";
-                    clearInputBuffer();
-                    year = 2025;  // Current year
-                } else {
-                    clearInputBuffer();
-                }
+    struct alignas(64) Slot {
+        atomic<uint64_t> epoch;
+        atomic<bool> inUse;
+        Slot() : epoch(IDLE), inUse(false) {}
+    };
 
-                catalog.addBook(id, title, author, year);
-                break;
+    struct Retired {
+        void* ptr;
+        void (*deleter)(void*);
+        uint64_t epoch;
+    };
 
-            case 2:
-                catalog.displayAllBooks();
-                break;
+    atomic<uint64_t> globalEpoch;
+    Slot slots[MAX_THREADS];
+    mutex retireLock;
+    vector<Retired> retired;
 
-            case 3:
-                catalog.displayAllBooksPreOrder();
-                break;
+    // Each thread claims a slot on first use and gives it back when it exits
+    struct SlotOwner {
+        EpochManager* manager;
+        int index;
+        SlotOwner() : manager(nullptr), index(-1) {}
+        ~SlotOwner() {
+            if (manager) {
+                manager->slots[index].inUse.store(false, memory_order_release);
+            }
+        }
+    };
 
-            case 4:
-                cout << "Enter book ID to search: ";
-                if (!(cin >> id)) {
-                    cout << "Invalid ID. Please enter a number.\n";
-                    clearInputBuffer();
-                    break;
-                }
-                clearInputBuffer();
+    int threadSlot();
+    bool tryAdvance();
 
-                if (catalog.searchBook(id)) {
-                    catalog.displayBook(id);
-                } else {
-                    cout << "Book with ID " << id << " not found!\n";
-                }
-                break;
+public:
+    EpochManager() : globalEpoch(0) {}
+    ~EpochManager();
 
-            case 5:
-                cout << "Enter book ID to remove: ";
-                if (!(cin >> id)) {
-                    cout << "Invalid ID. Please enter a number.\n";
-                    clearInputBuffer();
-                    break;
+    static EpochManager& instance();
+
+    void enter();
+    void exit();
+    void retire(void* ptr, void (*deleter)(void*));
+    void reclaim();
+};
+
+// RAII guard marking the calling thread as inside a read-side critical section
+class EpochGuard {
+private:
+    EpochManager& epochs;
+
+public:
+    EpochGuard(EpochManager& e) : epochs(e) { epochs.enter(); }
+    ~EpochGuard() { epochs.exit(); }
+};
+
+EpochManager& EpochManager::instance() {
+    static EpochManager manager;
+    return manager;
+}
+
+EpochManager::~EpochManager() {
+    for (Retired& r : retired) {
+        r.deleter(r.ptr);
+    }
+}
+
+// Find (or claim) the slot of the calling thread
+int EpochManager::threadSlot() {
+    thread_local SlotOwner owner;
+    if (owner.manager == this) {
+        return owner.index;
+    }
+    for (int i = 0; i < MAX_THREADS; i++) {
+        bool expected = false;
+        if (slots[i].inUse.compare_exchange_strong(expected, true)) {
+            owner.manager = this;
+            owner.index = i;
+            return i;
+        }
+    }
+    cerr << "Error: too many threads using the concurrent catalog!\n";
+    abort();
+}
+
+// Announce the current epoch before touching shared nodes
+void EpochManager::enter() {
+    Slot& slot = slots[threadSlot()];
+    slot.epoch.store(globalEpoch.load(memory_order_relaxed), memory_order_relaxed);
+    atomic_thread_fence(memory_order_seq_cst);
+}
+
+// Leave the read-side critical section
+void EpochManager::exit() {
+    slots[threadSlot()].epoch.store(IDLE, memory_order_release);
+}
+
+// Move the global epoch forward if every active thread has caught up with it
+bool EpochManager::tryAdvance() {
+    atomic_thread_fence(memory_order_seq_cst);
+    uint64_t current = globalEpoch.load(memory_order_relaxed);
+    for (int i = 0; i < MAX_THREADS; i++) {
+        uint64_t e = slots[i].epoch.load(memory_order_acquire);
+        if (e != IDLE && e != current) {
+            return false;
+        }
+    }
+    return globalEpoch.compare_exchange_strong(current, current + 1);
+}
+
+// Hand an unlinked node over for deferred deletion
+void EpochManager::retire(void* ptr, void (*deleter)(void*)) {
+    bool shouldReclaim;
+    {
+        lock_guard<mutex> guard(retireLock);
+        retired.push_back({ptr, deleter, globalEpoch.load()});
+        shouldReclaim = retired.size() >= 64;
+    }
+    if (shouldReclaim) {
+        reclaim();
+    }
+}
+
+// Free every retired node that no reader can reach any more
+void EpochManager::reclaim() {
+    tryAdvance();
+    uint64_t safe = globalEpoch.load();
+    vector<Retired> ready;
+    {
+        lock_guard<mutex> guard(retireLock);
+        size_t kept = 0;
+        for (size_t i = 0; i < retired.size(); i++) {
+            if (retired[i].epoch + 2 <= safe) {
+                ready.push_back(retired[i]);
+            } else {
+                retired[kept++] = retired[i];
+            }
+        }
+        retired.resize(kept);
+    }
+    for (Retired& r : ready) {
+        r.deleter(r.ptr);
+    }
+}
+
+// Node of the concurrent catalog's skip list
+struct CatalogNode {
+    static const int MAX_LEVEL = 24;
+
+    int id;
+    string title;
+    string author;
+    int year;
+    int topLevel;
+    atomic<CatalogNode*> next[MAX_LEVEL];
+    mutex lock;
+    atomic<bool> marked;
+    atomic<bool> fullyLinked;
+
+    CatalogNode(int i, string t, string a, int y, int level)
+        : id(i), title(t), author(a), year(y), topLevel(level), marked(false), fullyLinked(false) {
+        for (int l = 0; l < MAX_LEVEL; l++) {
+            next[l].store(nullptr, memory_order_relaxed);
+        }
+    }
+};
+
+// Concurrent Book Catalog implemented as a lazy skip list (Herlihy et al.).
+// Lookups take no locks and never block; writers lock only the handful of
+// predecessor nodes they relink, so inserts and deletes in different parts of
+// the catalog proceed in parallel. Removed nodes are reclaimed through epochs.
+class ConcurrentBookCatalog {
+private:
+    CatalogNode* head;
+    CatalogNode* tail;
+    EpochManager& epochs;
+
+    int randomLevel();
+    int findNode(int id, CatalogNode** preds, CatalogNode** succs);
+    static void deleteNode(void* node) { delete static_cast<CatalogNode*>(node); }
+
+public:
+    ConcurrentBookCatalog();
+    ~ConcurrentBookCatalog();
+
+    bool addBook(int id, string title, string author, int year);
+    bool searchBook(int id);
+    bool deleteBook(int id);
+    void displayBook(int id);
+    size_t size();
+};
+
+ConcurrentBookCatalog::ConcurrentBookCatalog() : epochs(EpochManager::instance()) {
+    head = new CatalogNode(numeric_limits<int>::min(), "", "", 0, CatalogNode::MAX_LEVEL - 1);
+    tail = new CatalogNode(numeric_limits<int>::max(), "", "", 0, CatalogNode::MAX_LEVEL - 1);
+    for (int l = 0; l < CatalogNode::MAX_LEVEL; l++) {
+        head->next[l].store(tail, memory_order_relaxed);
+    }
+    head->fullyLinked.store(true);
+    tail->fullyLinked.store(true);
+}
+
+// Must only run once no other thread uses the catalog
+ConcurrentBookCatalog::~ConcurrentBookCatalog() {
+    CatalogNode* node = head;
+    while (node != nullptr) {
+        CatalogNode* next = node->next[0].load(memory_order_relaxed);
+        delete node;
+        node = next;
+    }
+}
+
+// Geometric level distribution with p = 1/2
+int ConcurrentBookCatalog::randomLevel() {
+    thread_local mt19937 rng(random_device{}());
+    uint32_t bits = rng();
+    int level = 0;
+    while ((bits & 1) && level < CatalogNode::MAX_LEVEL - 1) {
+        bits >>= 1;
+        level++;
+    }
+    return level;
+}
+
+// Lock-free search filling predecessors/successors per level.
+// Returns the highest level at which the ID was found, or -1.
+int ConcurrentBookCatalog::findNode(int id, CatalogNode** preds, CatalogNode** succs) {
+    int found = -1;
+    CatalogNode* pred = head;
+    for (int l = CatalogNode::MAX_LEVEL - 1; l >= 0; l--) {
+        CatalogNode* curr = pred->next[l].load(memory_order_acquire);
+        while (id > curr->id) {
+            pred = curr;
+            curr = pred->next[l].load(memory_order_acquire);
+        }
+        if (found == -1 && id == curr->id) {
+            found = l;
+        }
+        preds[l] = pred;
+        succs[l] = curr;
+    }
+    return found;
+}
+
+// Insert a book; returns false if the ID is already present
+bool ConcurrentBookCatalog::addBook(int id, string title, string author, int year) {
+    int topLevel = randomLevel();
+    CatalogNode* preds[CatalogNode::MAX_LEVEL];
+    CatalogNode* succs[CatalogNode::MAX_LEVEL];
+    EpochGuard guard(epochs);
+
+    while (true) {
+        int found = findNode(id, preds, succs);
+        if (found != -1) {
+            CatalogNode* existing = succs[found];
+            if (!existing->marked.load(memory_order_acquire)) {
+                while (!existing->fullyLinked.load(memory_order_acquire)) {
+                    this_thread::yield();
                 }
-                clearInputBuffer();
+                return false;
+            }
+            continue;  // Being removed; retry once it is unlinked
+        }
 
-                catalog.deleteBook(id);
-                break;
+        // Lock predecessors bottom-up and check nothing changed underneath
+        int highestLocked = -1;
+        CatalogNode* prevPred = nullptr;
+        bool valid = true;
+        for (int l = 0; valid && l <= topLevel; l++) {
+            CatalogNode* pred = preds[l];
+            CatalogNode* succ = succs[l];
+            if (pred != prevPred) {
+                pred->lock.lock();
+                highestLocked = l;
+                prevPred = pred;
+            }
+            valid = !pred->marked.load(memory_order_acquire) && !succ->marked.load(memory_order_acquire) &&
+                    pred->next[l].load(memory_order_acquire) == succ;
+        }
+
+        if (valid) {
+            CatalogNode* node = new CatalogNode(id, title, author, year, topLevel);
+            for (int l = 0; l <= topLevel; l++) {
+                node->next[l].store(succs[l], memory_order_relaxed);
+            }
+            for (int l = 0; l <= topLevel; l++) {
+                preds[l]->next[l].store(node, memory_order_release);
+            }
+            node->fullyLinked.store(true, memory_order_release);
+        }
+
+        prevPred = nullptr;
+        for (int l = 0; l <= highestLocked; l++) {
+            if (preds[l] != prevPred) {
+                preds[l]->lock.unlock();
+                prevPred = preds[l];
+            }
+        }
+        if (valid) {
+            return true;
+        }
+    }
+}
+
+// Wait-free membership test
+bool ConcurrentBookCatalog::searchBook(int id) {
+    CatalogNode* preds[CatalogNode::MAX_LEVEL];
+    CatalogNode* succs[CatalogNode::MAX_LEVEL];
+    EpochGuard guard(epochs);
+    int found = findNode(id, preds, succs);
+    return found != -1 && succs[found]->fullyLinked.load(memory_order_acquire) &&
+           !succs[found]->marked.load(memory_order_acquire);
+}
+
+// Remove a book; returns false if the ID is not present
+bool ConcurrentBookCatalog::deleteBook(int id) {
+    CatalogNode* preds[CatalogNode::MAX_LEVEL];
+    CatalogNode* succs[CatalogNode::MAX_LEVEL];
+    CatalogNode* victim = nullptr;
+    bool isMarked = false;
+    int topLevel = -1;
+    EpochGuard guard(epochs);
+
+    while (true) {
+        int found = findNode(id, preds, succs);
+        if (!isMarked) {
+            if (found == -1) {
+                return false;
+            }
+            victim = succs[found];
+            if (!victim->fullyLinked.load(memory_order_acquire) || victim->topLevel != found ||
+                victim->marked.load(memory_order_acquire)) {
+                return false;
+            }
+            topLevel = victim->topLevel;
+            victim->lock.lock();
+            if (victim->marked.load(memory_order_acquire)) {
+                victim->lock.unlock();
+                return false;
+            }
+            victim->marked.store(true, memory_order_release);
+            isMarked = true;
+        }
+
+        int highestLocked = -1;
+        CatalogNode* prevPred = nullptr;
+        bool valid = true;
+        for (int l = 0; valid && l <= topLevel; l++) {
+            CatalogNode* pred = preds[l];
+            if (pred != prevPred) {
+                pred->lock.lock();
+                highestLocked = l;
+                prevPred = pred;
+            }
+            valid = !pred->marked.load(memory_order_acquire) && pred->next[l].load(memory_order_acquire) == victim;
+        }
+
+        if (valid) {
+            for (int l = topLevel; l >= 0; l--) {
+                preds[l]->next[l].store(victim->next[l].load(memory_order_acquire), memory_order_release);
+            }
+            victim->lock.unlock();
+        }
+
+        prevPred = nullptr;
+        for (int l = 0; l <= highestLocked; l++) {
+            if (preds[l] != prevPred) {
+                preds[l]->lock.unlock();
+                prevPred = preds[l];
+            }
+        }
+        if (valid) {
+            epochs.retire(victim, deleteNode);
+            return true;
+        }
+    }
+}
+
+// Print a book's details without blocking writers
+void ConcurrentBookCatalog::displayBook(int id) {
+    CatalogNode* preds[CatalogNode::MAX_LEVEL];
+    CatalogNode* succs[CatalogNode::MAX_LEVEL];
+    EpochGuard guard(epochs);
+    int found = findNode(id, preds, succs);
+    if (found == -1 || !succs[found]->fullyLinked.load(memory_order_acquire) ||
+        succs[found]->marked.load(memory_order_acquire)) {
+        cout << "Book with ID " << id << " not found!\n";
+        return;
+    }
+
+    CatalogNode* book = succs[found];
+    cout << "\n===== Book Details =====\n";
+    cout << "ID: " << book->id << endl;
+    cout << "Title: " << book->title << endl;
+    cout << "Author: " << book->author << endl;
+    cout << "Year: " << book->year << endl;
+    cout << "========================\n\n";
+}
+
+// Count live books (a moving target while writers are active)
+size_t ConcurrentBookCatalog::size() {
+    EpochGuard guard(epochs);
+    size_t count = 0;
+    CatalogNode* node = head->next[0].load(memory_order_acquire);
+    while (node != tail) {
+        if (!node->marked.load(memory_order_acquire)) {
+            count++;
+        }
+        node = node->next[0].load(memory_order_acquire);
+    }
+    return count;
+}
+
+// Multi-threaded throughput benchmark with mixed read/write ratios
+void runConcurrentBenchmark() {
+    const int KEY_RANGE = 200000;
+    const int OPS_PER_THREAD = 200000;
+    const int threadCounts[] = {1, 2, 4, 8};
+    const int readPercents[] = {100, 95, 80, 50};
+
+    cout << "\n===== Concurrent Catalog Benchmark =====\n";
+    cout << "Catalog prefilled with " << KEY_RANGE / 2 << " books, IDs drawn from 0-" << KEY_RANGE - 1 << "\n";
+    cout << "Hardware threads: " << thread::hardware_concurrency() << "\n";
+    cout << left << setw(10) << "Threads" << setw(10) << "Reads" << setw(14) << "Mops/sec" << "\n";
+    cout << string(34, '-') << endl;
+
+    for (int readPercent : readPercents) {
+        for (int threads : threadCounts) {
+            ConcurrentBookCatalog catalog;
+            for (int id = 0; id < KEY_RANGE; id += 2) {
+                catalog.addBook(id, "Book", "Author", 2000);
+            }
+
+            atomic<bool> start(false);
+            vector<thread> workers;
+            for (int t = 0; t < threads; t++) {
+                workers.emplace_back([&, t]() {
+                    mt19937 rng(t * 7919 + readPercent);
+                    uniform_int_distribution<int> keyDist(0, KEY_RANGE - 1);
+                    uniform_int_distribution<int> opDist(0, 99);
+                    while (!start.load()) {
+                        this_thread::yield();
+                    }
+                    for (int i = 0; i < OPS_PER_THREAD; i++) {
+                        int id = keyDist(rng);
+                        int op = opDist(rng);
+                        if (op < readPercent) {
+                            catalog.searchBook(id);
+                        } else if ((op - readPercent) % 2 == 0) {
+                            catalog.addBook(id, "Book", "Author", 2000);
+                        } else {
+                            catalog.deleteBook(id);
+                        }
+                    }
+                });
+            }
+
+            auto begin = chrono::steady_clock::now();
+            start.store(true);
+            for (thread& w : workers) {
+                w.join();
+            }
+            double seconds = chrono::duration<double>(chrono::steady_clock::now() - begin).count();
+            double mops = (double)threads * OPS_PER_THREAD / seconds / 1e6;
+            cout << left << setw(10) << threads << setw(10) << (to_string(readPercent) + "%")
+                 << fixed << setprecision(2) << setw(14) << mops << "\n";
+        }
+    }
+    cout << "========================================\n\n";
+}
+
+// Book record as stored by the disk-backed catalog
+struct StoredBook {
+    int id;
+    string title;
+    string author;
+    int year;
+};
+
+// CRC-32 (IEEE) used to detect torn or corrupt log records
+uint32_t crc32(const uint8_t* data, size_t length) {
+    static uint32_t table[256];
+    static bool initialized = false;
+    if (!initialized) {
+        for (uint32_t i = 0; i < 256; i++) {
+            uint32_t c = i;
+            for (int k = 0; k < 8; k++) {
+                c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+            }
+            table[i] = c;
+        }
+        initialized = true;
+    }
+    uint32_t crc = 0xFFFFFFFFu;
+    for (size_t i = 0; i < length; i++) {
+        crc = table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+    }
+    return crc ^ 0xFFFFFFFFu;
+}
+
+// Disk-backed Book Catalog.
+//
+// The catalog lives in two files inside its directory:
+//   catalog.pages - the last checkpoint, a static B+tree of 4 KB pages that is
+//                   mmap'ed and read in place (page 0 is the file header,
+//                   leaves follow in ID order, interior levels come last)
+//   catalog.wal   - a write-ahead log of every addBook/deleteBook since then
+//
+// Changes are logged before they are applied to an in-memory table that
+// shadows the checkpoint. Writers share fsyncs through group commit, and once
+// the log grows past a threshold a checkpoint merges everything into a new
+// page file and truncates the log. Opening the catalog therefore only maps
+// the page file and replays the log tail.
+class DiskBookCatalog {
+private:
+    static const uint32_t PAGE_SIZE = 4096;
+    static const uint64_t PAGE_MAGIC = 0x31305441434B4F42ULL;  // "BOKCAT01"
+    static const size_t CHECKPOINT_LOG_BYTES = 4 << 20;
+    static const uint8_t LOG_ADD = 1;
+    static const uint8_t LOG_DELETE = 2;
+
+    struct FileHeader {
+        uint64_t magic;
+        uint32_t pageSize;
+        uint32_t leafCount;
+        uint32_t pageCount;
+        uint32_t rootPage;
+        uint64_t bookCount;
+    };
+
+    // Leaf pages hold a slot array growing forward and records growing back
+    // from the end of the page; interior pages hold (firstId, page) entries.
+    struct PageHeader {
+        uint16_t count;
+        uint16_t isLeaf;
+        int32_t firstId;
+    };
+
+    struct IndexEntry {
+        int32_t firstId;
+        uint32_t page;
+    };
+
+    // In-memory change since the last checkpoint; deleted marks a tombstone
+    struct MemEntry {
+        bool deleted;
+        StoredBook book;
+    };
+
+    string directory;
+    int walFd;
+    int pageFd;
+    const uint8_t* pages;
+    size_t pagesLength;
+    FileHeader header;
+    map<int, MemEntry> memtable;
+    uint64_t bookCount;
+    size_t walBytes;
+    bool open;
+
+    // Group commit state
+    mutex lock;
+    condition_variable flushedCondition;
+    string pending;
+    int pendingRecords;
+    uint64_t nextLsn;
+    uint64_t durableLsn;
+    bool flushing;
+    int syncBatch;
+    uint64_t fsyncCount;
+    double recoveryMillis;
+
+    string pagesPath() const { return directory + "/catalog.pages"; }
+    string walPath() const { return directory + "/catalog.wal"; }
+
+    bool mapPages();
+    void unmapPages();
+    bool replayLog();
+    bool findOnDisk(int id, StoredBook& out);
+    bool lookupLocked(int id, StoredBook& out);
+    void appendRecord(uint8_t type, const StoredBook& book);
+    bool waitDurable(unique_lock<mutex>& guard, uint64_t lsn);
+    void failLocked();
+    bool checkpointLocked(unique_lock<mutex>& guard);
+    template <typename Visitor> void forEachOnDisk(Visitor visit);
+
+    static size_t recordSize(const StoredBook& book) { return 12 + book.title.size() + book.author.size(); }
+    static void encodeRecord(uint8_t* dest, const StoredBook& book);
+    static void decodeRecord(const uint8_t* src, StoredBook& book);
+
+public:
+    static const size_t MAX_RECORD_SIZE = PAGE_SIZE / 2;
+
+    DiskBookCatalog(const string& dir, int batch = 1);
+    ~DiskBookCatalog();
+
+    bool isOpen() const { return open; }
+    bool addBook(int id, const string& title, const string& author, int year);
+    bool deleteBook(int id);
+    bool findBook(int id, StoredBook& out);
+    bool searchBook(int id);
+    void displayAllBooks();
+    bool commit();
+    bool checkpoint();
+    uint64_t size();
+    uint64_t syncCount();
+    size_t logSize();
+    double lastRecoveryMillis() const { return recoveryMillis; }
+};
+
+// Write all bytes, retrying on short writes
+static bool writeFully(int fd, const void* data, size_t length) {
+    const char* p = static_cast<const char*>(data);
+    while (length > 0) {
+        ssize_t written = write(fd, p, length);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        p += written;
+        length -= written;
+    }
+    return true;
+}
+
+// Make a rename or file creation in the directory durable
+static bool syncDirectory(const string& dir) {
+    int fd = ::open(dir.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+    bool ok = fsync(fd) == 0;
+    close(fd);
+    return ok;
+}
+
+// Open (or create) the catalog and recover it from the checkpoint plus log tail
+DiskBookCatalog::DiskBookCatalog(const string& dir, int batch)
+    : directory(dir), walFd(-1), pageFd(-1), pages(nullptr), pagesLength(0), bookCount(0), walBytes(0),
+      open(false), pendingRecords(0), nextLsn(0), durableLsn(0), flushing(false), syncBatch(max(batch, 1)),
+      fsyncCount(0), recoveryMillis(0) {
+    auto begin = chrono::steady_clock::now();
+    memset(&header, 0, sizeof(header));
+
+    if (mkdir(directory.c_str(), 0755) != 0 && errno != EEXIST) {
+        cout << "Error: cannot create catalog directory " << directory << ": " << strerror(errno) << "\n";
+        return;
+    }
+    if (!mapPages()) {
+        return;
+    }
+    walFd = ::open(walPath().c_str(), O_RDWR | O_CREAT | O_APPEND, 0644);
+    if (walFd < 0) {
+        cout << "Error: cannot open " << walPath() << ": " << strerror(errno) << "\n";
+        return;
+    }
+    bookCount = header.bookCount;
+    if (!replayLog()) {
+        return;
+    }
+    open = true;
+    recoveryMillis = chrono::duration<double, milli>(chrono::steady_clock::now() - begin).count();
+}
+
+DiskBookCatalog::~DiskBookCatalog() {
+    if (open) {
+        commit();
+    }
+    if (walFd >= 0) {
+        close(walFd);
+    }
+    unmapPages();
+}
+
+// Map the checkpoint file; a missing file is an empty catalog
+bool DiskBookCatalog::mapPages() {
+    pageFd = ::open(pagesPath().c_str(), O_RDONLY);
+    if (pageFd < 0) {
+        if (errno == ENOENT) {
+            return true;
+        }
+        cout << "Error: cannot open " << pagesPath() << ": " << strerror(errno) << "\n";
+        return false;
+    }
+    struct stat info;
+    if (fstat(pageFd, &info) != 0 || info.st_size < (off_t)PAGE_SIZE) {
+        cout << "Error: " << pagesPath() << " is truncated\n";
+        return false;
+    }
+    pagesLength = info.st_size;
+    void* mapped = mmap(nullptr, pagesLength, PROT_READ, MAP_SHARED, pageFd, 0);
+    if (mapped == MAP_FAILED) {
+        cout << "Error: cannot map " << pagesPath() << ": " << strerror(errno) << "\n";
+        pagesLength = 0;
+        return false;
+    }
+    pages = static_cast<const uint8_t*>(mapped);
+    memcpy(&header, pages, sizeof(header));
+    if (header.magic != PAGE_MAGIC || header.pageSize != PAGE_SIZE ||
+        (uint64_t)header.pageCount * PAGE_SIZE > pagesLength) {
+        cout << "Error: " << pagesPath() << " is not a catalog page file\n";
+        return false;
+    }
+    return true;
+}
+
+void DiskBookCatalog::unmapPages() {
+    if (pages != nullptr) {
+        munmap(const_cast<uint8_t*>(pages), pagesLength);
+        pages = nullptr;
+        pagesLength = 0;
+    }
+    if (pageFd >= 0) {
+        close(pageFd);
+        pageFd = -1;
+    }
+    memset(&header, 0, sizeof(header));
+}
+
+// Record layout: id, year, title length, author length, title, author
+void DiskBookCatalog::encodeRecord(uint8_t* dest, const StoredBook& book) {
+    int32_t id = book.id;
+    int32_t year = book.year;
+    uint16_t titleLength = book.title.size();
+    uint16_t authorLength = book.author.size();
+    memcpy(dest, &id, 4);
+    memcpy(dest + 4, &year, 4);
+    memcpy(dest + 8, &titleLength, 2);
+    memcpy(dest + 10, &authorLength, 2);
+    memcpy(dest + 12, book.title.data(), titleLength);
+    memcpy(dest + 12 + titleLength, book.author.data(), authorLength);
+}
+
+void DiskBookCatalog::decodeRecord(const uint8_t* src, StoredBook& book) {
+    int32_t id, year;
+    uint16_t titleLength, authorLength;
+    memcpy(&id, src, 4);
+    memcpy(&year, src + 4, 4);
+    memcpy(&titleLength, src + 8, 2);
+    memcpy(&authorLength, src + 10, 2);
+    book.id = id;
+    book.year = year;
+    book.title.assign(reinterpret_cast<const char*>(src + 12), titleLength);
+    book.author.assign(reinterpret_cast<const char*>(src + 12 + titleLength), authorLength);
+}
+
+// Replay the log into the memtable, cutting off a torn tail if there is one.
+// Log frame: payload length, CRC of payload, payload (type byte + record).
+bool DiskBookCatalog::replayLog() {
+    struct stat info;
+    if (fstat(walFd, &info) != 0) {
+        cout << "Error: cannot stat " << walPath() << "\n";
+        return false;
+    }
+    string log(info.st_size, '\0');
+    size_t got = 0;
+    while (got < log.size()) {
+        ssize_t n = pread(walFd, &log[got], log.size() - got, got);
+        if (n <= 0) {
+            cout << "Error: cannot read " << walPath() << "\n";
+            return false;
+        }
+        got += n;
+    }
+
+    const uint8_t* data = reinterpret_cast<const uint8_t*>(log.data());
+    size_t offset = 0;
+    while (offset + 8 <= log.size()) {
+        uint32_t length, crc;
+        memcpy(&length, data + offset, 4);
+        memcpy(&crc, data + offset + 4, 4);
+        if (length < 13 || offset + 8 + length > log.size() || crc32(data + offset + 8, length) != crc) {
+            break;
+        }
+        const uint8_t* payload = data + offset + 8;
+        StoredBook book;
+        decodeRecord(payload + 1, book);
+        StoredBook existing;
+        bool exists = lookupLocked(book.id, existing);
+        if (payload[0] == LOG_ADD) {
+            memtable[book.id] = {false, book};
+            if (!exists) {
+                bookCount++;
+            }
+        } else {
+            memtable[book.id] = {true, book};
+            if (exists) {
+                bookCount--;
+            }
+        }
+        offset += 8 + length;
+        nextLsn++;
+    }
+    durableLsn = nextLsn;
+
+    if (offset != log.size()) {
+        cout << "Recovered catalog log: discarding " << log.size() - offset << " bytes of incomplete records\n";
+        if (ftruncate(walFd, offset) != 0 || fsync(walFd) != 0) {
+            cout << "Error: cannot truncate " << walPath() << "\n";
+            return false;
+        }
+    }
+    walBytes = offset;
+    return true;
+}
+
+// Descend the page tree to the leaf that may hold the ID
+bool DiskBookCatalog::findOnDisk(int id, StoredBook& out) {
+    if (pages == nullptr || header.bookCount == 0) {
+        return false;
+    }
+    uint32_t pageNumber = header.rootPage;
+    while (true) {
+        const uint8_t* page = pages + (size_t)pageNumber * PAGE_SIZE;
+        PageHeader ph;
+        memcpy(&ph, page, sizeof(ph));
+        if (ph.isLeaf) {
+            int low = 0, high = ph.count - 1;
+            while (low <= high) {
+                int mid = (low + high) / 2;
+                uint16_t slot;
+                memcpy(&slot, page + sizeof(ph) + mid * 2, 2);
+                int32_t midId;
+                memcpy(&midId, page + slot, 4);
+                if (midId == id) {
+                    decodeRecord(page + slot, out);
+                    return true;
+                } else if (midId < id) {
+                    low = mid + 1;
+                } else {
+                    high = mid - 1;
+                }
+            }
+            return false;
+        }
+
+        // Last child whose first ID is <= id
+        int low = 0, high = ph.count - 1, child = 0;
+        while (low <= high) {
+            int mid = (low + high) / 2;
+            IndexEntry entry;
+            memcpy(&entry, page + sizeof(ph) + mid * sizeof(IndexEntry), sizeof(entry));
+            if (entry.firstId <= id) {
+                child = mid;
+                low = mid + 1;
+            } else {
+                high = mid - 1;
+            }
+        }
+        IndexEntry entry;
+        memcpy(&entry, page + sizeof(ph) + child * sizeof(IndexEntry), sizeof(entry));
+        pageNumber = entry.page;
+    }
+}
+
+// Visit every checkpointed book in ID order by scanning the leaf pages
+template <typename Visitor>
+void DiskBookCatalog::forEachOnDisk(Visitor visit) {
+    if (pages == nullptr) {
+        return;
+    }
+    for (uint32_t p = 1; p <= header.leafCount; p++) {
+        const uint8_t* page = pages + (size_t)p * PAGE_SIZE;
+        PageHeader ph;
+        memcpy(&ph, page, sizeof(ph));
+        for (int i = 0; i < ph.count; i++) {
+            uint16_t slot;
+            memcpy(&slot, page + sizeof(ph) + i * 2, 2);
+            StoredBook book;
+            decodeRecord(page + slot, book);
+            visit(book);
+        }
+    }
+}
+
+// Look a book up in the memtable first, then in the checkpoint
+bool DiskBookCatalog::lookupLocked(int id, StoredBook& out) {
+    auto it = memtable.find(id);
+    if (it != memtable.end()) {
+        if (it->second.deleted) {
+            return false;
+        }
+        out = it->second.book;
+        return true;
+    }
+    return findOnDisk(id, out);
+}
+
+// Buffer a log record for the next group commit
+void DiskBookCatalog::appendRecord(uint8_t type, const StoredBook& book) {
+    uint32_t length = 1 + recordSize(book);
+    size_t start = pending.size();
+    pending.resize(start + 8 + length);
+    uint8_t* frame = reinterpret_cast<uint8_t*>(&pending[start]);
+    frame[8] = type;
+    encodeRecord(frame + 9, book);
+    uint32_t crc = crc32(frame + 8, length);
+    memcpy(frame, &length, 4);
+    memcpy(frame + 4, &crc, 4);
+    pendingRecords++;
+    nextLsn++;
+}
+
+// Block until the given log sequence number is on disk. The first waiter
+// becomes the leader and writes and fsyncs everything buffered so far, so
+// concurrent writers share one fsync.
+bool DiskBookCatalog::waitDurable(unique_lock<mutex>& guard, uint64_t lsn) {
+    while (durableLsn < lsn) {
+        if (!open) {
+            return false;  // The batch holding this LSN was lost
+        }
+        if (flushing) {
+            flushedCondition.wait(guard);
+            continue;
+        }
+        flushing = true;
+        string batch;
+        batch.swap(pending);
+        pendingRecords = 0;
+        uint64_t batchLsn = nextLsn;
+
+        guard.unlock();
+        bool ok = writeFully(walFd, batch.data(), batch.size()) && fdatasync(walFd) == 0;
+        guard.lock();
+
+        flushing = false;
+        fsyncCount++;
+        flushedCondition.notify_all();
+        if (!ok) {
+            cout << "Error: cannot write " << walPath() << ": " << strerror(errno) << "\n";
+            failLocked();
+            return false;
+        }
+        walBytes += batch.size();
+        durableLsn = batchLsn;
+    }
+    return true;
+}
+
+// A log write or sync failed, so the changes after the last synced record
+// are lost. Cut the log back to that record, rebuild the memtable from what
+// is left so no unlogged change stays visible, and stop taking changes:
+// every waiter and every later add, delete or commit returns false.
+void DiskBookCatalog::failLocked() {
+    open = false;
+    pending.clear();
+    pendingRecords = 0;
+    if (ftruncate(walFd, walBytes) != 0 || fdatasync(walFd) != 0) {
+        cout << "Error: cannot truncate " << walPath() << "\n";
+    }
+    uint64_t synced = durableLsn;
+    memtable.clear();
+    bookCount = header.bookCount;
+    replayLog();
+    nextLsn = durableLsn = synced;
+    cout << "Error: catalog " << directory << " is read-only until it is reopened\n";
+}
+
+// Add a book; durable on return when syncing per operation, otherwise once
+// the batch fills up or commit() is called. Returns false if the ID is taken
+// or the change could not be logged (the catalog is then no longer open).
+bool DiskBookCatalog::addBook(int id, const string& title, const string& author, int year) {
+    StoredBook book = {id, title, author, year};
+    if (recordSize(book) > MAX_RECORD_SIZE) {
+        cout << "Error: title and author of book " << id << " are too long to store!\n";
+        return false;
+    }
+
+    unique_lock<mutex> guard(lock);
+    StoredBook existing;
+    if (!open || lookupLocked(id, existing)) {
+        return false;
+    }
+    appendRecord(LOG_ADD, book);
+    memtable[id] = {false, book};
+    bookCount++;
+
+    bool ok = true;
+    if (syncBatch == 1 || pendingRecords >= syncBatch) {
+        ok = waitDurable(guard, nextLsn);
+    }
+    if (ok && walBytes > CHECKPOINT_LOG_BYTES) {
+        ok = checkpointLocked(guard);
+    }
+    return ok;
+}
+
+// Delete a book; durability follows the same rules as addBook
+bool DiskBookCatalog::deleteBook(int id) {
+    unique_lock<mutex> guard(lock);
+    StoredBook existing;
+    if (!open || !lookupLocked(id, existing)) {
+        return false;
+    }
+    appendRecord(LOG_DELETE, existing);
+    memtable[id] = {true, existing};
+    bookCount--;
+
+    bool ok = true;
+    if (syncBatch == 1 || pendingRecords >= syncBatch) {
+        ok = waitDurable(guard, nextLsn);
+    }
+    if (ok && walBytes > CHECKPOINT_LOG_BYTES) {
+        ok = checkpointLocked(guard);
+    }
+    return ok;
+}
+
+bool DiskBookCatalog::findBook(int id, StoredBook& out) {
+    lock_guard<mutex> guard(lock);
+    return lookupLocked(id, out);
+}
+
+bool DiskBookCatalog::searchBook(int id) {
+    StoredBook book;
+    return findBook(id, book);
+}
+
+// Make every buffered change durable
+bool DiskBookCatalog::commit() {
+    unique_lock<mutex> guard(lock);
+    return open && waitDurable(guard, nextLsn);
+}
+
+bool DiskBookCatalog::checkpoint() {
+    unique_lock<mutex> guard(lock);
+    return open && checkpointLocked(guard);
+}
+
+// Merge the checkpoint and the memtable into a new page file, atomically
+// replace the old one, then truncate the log
+bool DiskBookCatalog::checkpointLocked(unique_lock<mutex>& guard) {
+    if (!waitDurable(guard, nextLsn)) {
+        return false;
+    }
+    while (flushing) {
+        flushedCondition.wait(guard);
+    }
+
+    string tempPath = pagesPath() + ".tmp";
+    int fd = ::open(tempPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        cout << "Error: cannot create " << tempPath << ": " << strerror(errno) << "\n";
+        return false;
+    }
+
+    vector<uint8_t> page(PAGE_SIZE, 0);
+    vector<IndexEntry> level;
+    uint32_t pageCount = 1;
+    uint64_t written = 0;
+    bool ok = writeFully(fd, page.data(), PAGE_SIZE);  // Header placeholder
+
+    // Leaves: slots grow after the page header, records grow from the end
+    PageHeader leaf = {0, 1, 0};
+    size_t recordStart = PAGE_SIZE;
+    auto flushLeaf = [&]() {
+        if (leaf.count == 0) {
+            return;
+        }
+        memcpy(page.data(), &leaf, sizeof(leaf));
+        ok = ok && writeFully(fd, page.data(), PAGE_SIZE);
+        level.push_back({leaf.firstId, pageCount++});
+        fill(page.begin(), page.end(), 0);
+        leaf.count = 0;
+        recordStart = PAGE_SIZE;
+    };
+    auto emit = [&](const StoredBook& book) {
+        size_t size = recordSize(book);
+        size_t slotEnd = sizeof(PageHeader) + (leaf.count + 1) * 2;
+        if (recordStart < size || recordStart - size < slotEnd) {
+            flushLeaf();
+        }
+        if (leaf.count == 0) {
+            leaf.firstId = book.id;
+        }
+        recordStart -= size;
+        encodeRecord(page.data() + recordStart, book);
+        uint16_t slot = recordStart;
+        memcpy(page.data() + sizeof(PageHeader) + leaf.count * 2, &slot, 2);
+        leaf.count++;
+        written++;
+    };
+
+    // Merge the sorted checkpoint with the sorted memtable
+    auto mem = memtable.begin();
+    forEachOnDisk([&](const StoredBook& book) {
+        while (mem != memtable.end() && mem->first < book.id) {
+            if (!mem->second.deleted) {
+                emit(mem->second.book);
+            }
+            ++mem;
+        }
+        if (mem != memtable.end() && mem->first == book.id) {
+            if (!mem->second.deleted) {
+                emit(mem->second.book);
+            }
+            ++mem;
+        } else {
+            emit(book);
+        }
+    });
+    for (; mem != memtable.end(); ++mem) {
+        if (!mem->second.deleted) {
+            emit(mem->second.book);
+        }
+    }
+    flushLeaf();
+    uint32_t leafCount = pageCount - 1;
+
+    // Interior levels, built bottom-up until a single root remains
+    const size_t fanout = (PAGE_SIZE - sizeof(PageHeader)) / sizeof(IndexEntry);
+    uint32_t rootPage = level.empty() ? 0 : level[0].page;
+    while (level.size() > 1) {
+        vector<IndexEntry> parents;
+        for (size_t i = 0; i < level.size(); i += fanout) {
+            size_t count = min(fanout, level.size() - i);
+            PageHeader interior = {(uint16_t)count, 0, level[i].firstId};
+            fill(page.begin(), page.end(), 0);
+            memcpy(page.data(), &interior, sizeof(interior));
+            memcpy(page.data() + sizeof(interior), &level[i], count * sizeof(IndexEntry));
+            ok = ok && writeFully(fd, page.data(), PAGE_SIZE);
+            parents.push_back({level[i].firstId, pageCount++});
+        }
+        level.swap(parents);
+        rootPage = level[0].page;
+    }
+
+    FileHeader newHeader = {PAGE_MAGIC, PAGE_SIZE, leafCount, pageCount, rootPage, written};
+    fill(page.begin(), page.end(), 0);
+    memcpy(page.data(), &newHeader, sizeof(newHeader));
+    ok = ok && pwrite(fd, page.data(), PAGE_SIZE, 0) == (ssize_t)PAGE_SIZE;
+    ok = ok && fsync(fd) == 0;
+    close(fd);
+    if (!ok) {
+        cout << "Error: cannot write " << tempPath << ": " << strerror(errno) << "\n";
+        unlink(tempPath.c_str());
+        return false;
+    }
+
+    // Rename is the commit point; replaying the old log on top of the new
+    // pages after a crash here is harmless because replay is idempotent
+    if (rename(tempPath.c_str(), pagesPath().c_str()) != 0 || !syncDirectory(directory)) {
+        cout << "Error: cannot install " << pagesPath() << ": " << strerror(errno) << "\n";
+        return false;
+    }
+    unmapPages();
+    memtable.clear();
+    if (!mapPages()) {
+        open = false;
+        return false;
+    }
+    if (ftruncate(walFd, 0) != 0 || fsync(walFd) != 0) {
+        cout << "Error: cannot truncate " << walPath() << "\n";
+        return false;
+    }
+    walBytes = 0;
+    fsyncCount += 3;
+    return true;
+}
+
+// Display all books in ID order, merging the checkpoint with newer changes
+void DiskBookCatalog::displayAllBooks() {
+    lock_guard<mutex> guard(lock);
+    cout << "\n===== Persistent Book Catalog =====\n";
+    if (bookCount == 0) {
+        cout << "Catalog is empty!\n";
+        cout << "===================================\n\n";
+        return;
+    }
+    cout << left << setw(6) << "ID" << setw(30) << "Title" << setw(20) << "Author" << "Year\n";
+    cout << string(60, '-') << endl;
+
+    auto print = [](const StoredBook& book) {
+        cout << left << setw(6) << book.id << setw(30) << book.title << setw(20) << book.author << book.year << endl;
+    };
+    auto mem = memtable.begin();
+    forEachOnDisk([&](const StoredBook& book) {
+        while (mem != memtable.end() && mem->first < book.id) {
+            if (!mem->second.deleted) {
+                print(mem->second.book);
+            }
+            ++mem;
+        }
+        if (mem != memtable.end() && mem->first == book.id) {
+            if (!mem->second.deleted) {
+                print(mem->second.book);
+            }
+            ++mem;
+        } else {
+            print(book);
+        }
+    });
+    for (; mem != memtable.end(); ++mem) {
+        if (!mem->second.deleted) {
+            print(mem->second.book);
+        }
+    }
+    cout << "===================================\n\n";
+}
+
+uint64_t DiskBookCatalog::size() {
+    lock_guard<mutex> guard(lock);
+    return bookCount;
+}
+
+uint64_t DiskBookCatalog::syncCount() {
+    lock_guard<mutex> guard(lock);
+    return fsyncCount;
+}
+
+size_t DiskBookCatalog::logSize() {
+    lock_guard<mutex> guard(lock);
+    return walBytes + pending.size();
+}
+
+// Remove a benchmark catalog directory
+static void removeCatalogFiles(const string& dir) {
+    unlink((dir + "/catalog.pages").c_str());
+    unlink((dir + "/catalog.pages.tmp").c_str());
+    unlink((dir + "/catalog.wal").c_str());
+    rmdir(dir.c_str());
+}
+
+// Report write throughput with and without fsync batching, and recovery time
+void runStorageBenchmark() {
+    char pattern[] = "/tmp/bookcatalog_benchXXXXXX";
+    if (mkdtemp(pattern) == nullptr) {
+        cout << "Error: cannot create a benchmark directory: " << strerror(errno) << "\n";
+        return;
+    }
+    string base = pattern;
+
+    cout << "\n===== Storage Engine Benchmark =====\n";
+    cout << left << setw(34) << "Mode" << setw(10) << "Writes" << setw(10) << "fsyncs" << "Writes/sec\n";
+    cout << string(66, '-') << endl;
+
+    struct Mode {
+        const char* name;
+        int threads;
+        int batch;
+        int writes;
+    };
+    const Mode modes[] = {
+        {"fsync every write, 1 thread", 1, 1, 2000},
+        {"fsync every write, 8 threads", 8, 1, 4000},
+        {"group commit, batch of 64", 1, 64, 50000},
+        {"group commit, batch of 1024", 1, 1024, 200000},
+    };
+    for (const Mode& mode : modes) {
+        string dir = base + "/run";
+        {
+            DiskBookCatalog catalog(dir, mode.batch);
+            if (!catalog.isOpen()) {
+                break;
+            }
+            auto begin = chrono::steady_clock::now();
+            vector<thread> writers;
+            int perThread = mode.writes / mode.threads;
+            for (int t = 0; t < mode.threads; t++) {
+                writers.emplace_back([&, t]() {
+                    for (int i = 0; i < perThread; i++) {
+                        catalog.addBook(t * perThread + i, "Benchmark Title", "Benchmark Author", 2000);
+                    }
+                });
+            }
+            for (thread& w : writers) {
+                w.join();
+            }
+            catalog.commit();
+            double seconds = chrono::duration<double>(chrono::steady_clock::now() - begin).count();
+            cout << left << setw(34) << mode.name << setw(10) << mode.writes << setw(10) << catalog.syncCount()
+                 << fixed << setprecision(0) << mode.writes / seconds << "\n";
+        }
+        removeCatalogFiles(dir);
+    }
+
+    // Recovery replays only the log written since the last checkpoint
+    string dir = base + "/recovery";
+    {
+        DiskBookCatalog catalog(dir, 1024);
+        for (int i = 0; i < 200000; i++) {
+            catalog.addBook(i, "Benchmark Title", "Benchmark Author", 2000);
+        }
+        catalog.checkpoint();
+        for (int i = 200000; i < 201000; i++) {
+            catalog.addBook(i, "Benchmark Title", "Benchmark Author", 2000);
+        }
+    }
+    DiskBookCatalog reopened(dir, 1024);
+    cout << "\nReopened " << reopened.size() << " books (" << reopened.logSize() << " bytes of log) in "
+         << fixed << setprecision(2) << reopened.lastRecoveryMillis() << " ms\n";
+    removeCatalogFiles(dir);
+    rmdir(base.c_str());
+    cout << "====================================\n\n";
+}
+
+// Node of the versioned catalog. Nodes are immutable once published, so any
+// number of versions can share them; the book itself is shared as well, so
+// path copying only copies pointers and counts, never titles.
+struct VersionNode {
+    shared_ptr<const StoredBook> book;
+    shared_ptr<const VersionNode> left;
+    shared_ptr<const VersionNode> right;
+    int size;
+
+    VersionNode(shared_ptr<const StoredBook> b, shared_ptr<const VersionNode> l, shared_ptr<const VersionNode> r)
+        : book(b), left(l), right(r), size((l ? l->size : 0) + (r ? r->size : 0) + 1) {}
+};
+
+typedef shared_ptr<const VersionNode> VersionRoot;
+
+// Read-only view of one catalog version. Taking one is O(1); it keeps its
+// version alive and unchanged however many writes happen afterwards.
+class CatalogSnapshot {
+private:
+    VersionRoot root;
+    uint64_t versionNumber;
+
+public:
+    CatalogSnapshot(VersionRoot r = nullptr, uint64_t v = 0) : root(r), versionNumber(v) {}
+
+    uint64_t version() const { return versionNumber; }
+    int size() const { return root ? root->size : 0; }
+    bool findBook(int id, StoredBook& out) const;
+
+    // Visit books in ID order with an explicit stack (no recursion)
+    template <typename Visitor>
+    void forEach(Visitor visit) const {
+        vector<const VersionNode*> path;
+        const VersionNode* node = root.get();
+        while (node != nullptr || !path.empty()) {
+            while (node != nullptr) {
+                path.push_back(node);
+                node = node->left.get();
+            }
+            node = path.back();
+            path.pop_back();
+            visit(*node->book);
+            node = node->right.get();
+        }
+    }
+};
+
+bool CatalogSnapshot::findBook(int id, StoredBook& out) const {
+    const VersionNode* node = root.get();
+    while (node != nullptr) {
+        if (id < node->book->id) {
+            node = node->left.get();
+        } else if (id > node->book->id) {
+            node = node->right.get();
+        } else {
+            out = *node->book;
+            return true;
+        }
+    }
+    return false;
+}
+
+// Versioned Book Catalog built as a persistent, path-copying weight-balanced
+// tree. Every addBook/deleteBook copies only the O(log n) nodes on its path
+// and publishes a new root; unchanged subtrees are shared with older versions.
+// Readers grab a snapshot (an atomic load of the root) and never wait for
+// writers. Old versions are freed automatically once the last snapshot that
+// references them is released.
+class VersionedBookCatalog {
+private:
+    static const int DELTA = 3;
+    static const int RATIO = 2;
+
+    // The free atomic_load/atomic_store on shared_ptr are deprecated in C++20
+#ifdef __cpp_lib_atomic_shared_ptr
+    atomic<VersionRoot> root;
+    VersionRoot loadRoot() const { return root.load(); }
+    void storeRoot(const VersionRoot& node) { root.store(node); }
+#else
+    VersionRoot root;  // Accessed through loadRoot/storeRoot only
+    VersionRoot loadRoot() const { return atomic_load(&root); }
+    void storeRoot(const VersionRoot& node) { atomic_store(&root, node); }
+#endif
+    atomic<uint64_t> versionNumber;
+    mutex writeLock;   // Serializes writers; readers never take it
+
+    static int subtreeSize(const VersionRoot& node) { return node ? node->size : 0; }
+    static int weight(const VersionRoot& node) { return subtreeSize(node) + 1; }
+    static VersionRoot makeNode(const shared_ptr<const StoredBook>& book, const VersionRoot& left,
+                                const VersionRoot& right) {
+        return make_shared<const VersionNode>(book, left, right);
+    }
+    static VersionRoot balance(const shared_ptr<const StoredBook>& book, const VersionRoot& left,
+                               const VersionRoot& right);
+    static VersionRoot insertBook(const VersionRoot& node, const shared_ptr<const StoredBook>& book);
+    static VersionRoot removeBook(const VersionRoot& node, int id);
+    static VersionRoot removeMin(const VersionRoot& node, shared_ptr<const StoredBook>& minBook);
+
+public:
+    VersionedBookCatalog() : versionNumber(0) {}
+
+    bool addBook(int id, const string& title, const string& author, int year);
+    bool deleteBook(int id);
+    CatalogSnapshot snapshot() const;
+};
+
+// Build a node over two subtrees whose weights differ by at most one
+// insert or delete, rotating (by copying) when the balance is off
+VersionRoot VersionedBookCatalog::balance(const shared_ptr<const StoredBook>& book, const VersionRoot& left,
+                                          const VersionRoot& right) {
+    if (weight(right) > DELTA * weight(left)) {
+        if (weight(right->left) < RATIO * weight(right->right)) {
+            return makeNode(right->book, makeNode(book, left, right->left), right->right);
+        }
+        const VersionRoot& middle = right->left;
+        return makeNode(middle->book, makeNode(book, left, middle->left),
+                        makeNode(right->book, middle->right, right->right));
+    }
+    if (weight(left) > DELTA * weight(right)) {
+        if (weight(left->right) < RATIO * weight(left->left)) {
+            return makeNode(left->book, left->left, makeNode(book, left->right, right));
+        }
+        const VersionRoot& middle = left->right;
+        return makeNode(middle->book, makeNode(left->book, left->left, middle->left),
+                        makeNode(book, middle->right, right));
+    }
+    return makeNode(book, left, right);
+}
+
+// Returns the new subtree, or the same pointer if the ID already exists
+VersionRoot VersionedBookCatalog::insertBook(const VersionRoot& node, const shared_ptr<const StoredBook>& book) {
+    if (!node) {
+        return makeNode(book, nullptr, nullptr);
+    }
+    if (book->id < node->book->id) {
+        VersionRoot left = insertBook(node->left, book);
+        return left == node->left ? node : balance(node->book, left, node->right);
+    }
+    if (book->id > node->book->id) {
+        VersionRoot right = insertBook(node->right, book);
+        return right == node->right ? node : balance(node->book, node->left, right);
+    }
+    return node;
+}
+
+VersionRoot VersionedBookCatalog::removeMin(const VersionRoot& node, shared_ptr<const StoredBook>& minBook) {
+    if (!node->left) {
+        minBook = node->book;
+        return node->right;
+    }
+    return balance(node->book, removeMin(node->left, minBook), node->right);
+}
+
+// Returns the new subtree, or the same pointer if the ID is absent
+VersionRoot VersionedBookCatalog::removeBook(const VersionRoot& node, int id) {
+    if (!node) {
+        return node;
+    }
+    if (id < node->book->id) {
+        VersionRoot left = removeBook(node->left, id);
+        return left == node->left ? node : balance(node->book, left, node->right);
+    }
+    if (id > node->book->id) {
+        VersionRoot right = removeBook(node->right, id);
+        return right == node->right ? node : balance(node->book, node->left, right);
+    }
+    if (!node->left) {
+        return node->right;
+    }
+    if (!node->right) {
+        return node->left;
+    }
+    shared_ptr<const StoredBook> successor;
+    VersionRoot right = removeMin(node->right, successor);
+    return balance(successor, node->left, right);
+}
+
+// Publish a new version containing the book; false if the ID exists
+bool VersionedBookCatalog::addBook(int id, const string& title, const string& author, int year) {
+    auto book = make_shared<const StoredBook>(StoredBook{id, title, author, year});
+    lock_guard<mutex> guard(writeLock);
+    VersionRoot current = loadRoot();
+    VersionRoot updated = insertBook(current, book);
+    if (updated == current) {
+        return false;
+    }
+    storeRoot(updated);
+    versionNumber.fetch_add(1);
+    return true;
+}
+
+// Publish a new version without the book; false if the ID is absent
+bool VersionedBookCatalog::deleteBook(int id) {
+    lock_guard<mutex> guard(writeLock);
+    VersionRoot current = loadRoot();
+    VersionRoot updated = removeBook(current, id);
+    if (updated == current) {
+        return false;
+    }
+    storeRoot(updated);
+    versionNumber.fetch_add(1);
+    return true;
+}
+
+// O(1): share the current root. The version number may run ahead of the
+// root by a write that is being published concurrently.
+CatalogSnapshot VersionedBookCatalog::snapshot() const {
+    uint64_t version = versionNumber.load();
+    return CatalogSnapshot(loadRoot(), version);
+}
+
+// Show that a report over a snapshot stays consistent while ingest runs
+void runSnapshotDemo() {
+    const int INITIAL_BOOKS = 200000;
+    const int INGEST_WRITES = 100000;
+
+    cout << "\n===== Snapshot Isolation Demo =====\n";
+    VersionedBookCatalog catalog;
+    for (int id = 0; id < INITIAL_BOOKS; id++) {
+        catalog.addBook(id * 2, "Title " + to_string(id), "Author", 2000);
+    }
+
+    auto begin = chrono::steady_clock::now();
+    CatalogSnapshot report = catalog.snapshot();
+    double snapshotMicros = chrono::duration<double, micro>(chrono::steady_clock::now() - begin).count();
+
+    begin = chrono::steady_clock::now();
+    vector<StoredBook> deepCopy;
+    deepCopy.reserve(report.size());
+    report.forEach([&](const StoredBook& book) { deepCopy.push_back(book); });
+    double copyMicros = chrono::duration<double, micro>(chrono::steady_clock::now() - begin).count();
+    deepCopy.clear();
+
+    // Ingest keeps adding and deleting while the report scans its snapshot
+    atomic<bool> ingestDone(false);
+    thread ingest([&]() {
+        mt19937 rng(42);
+        for (int i = 0; i < INGEST_WRITES; i++) {
+            int id = rng() % (INITIAL_BOOKS * 2);
+            if (id % 2 == 0) {
+                catalog.deleteBook(id);
+            } else {
+                catalog.addBook(id, "New Title", "New Author", 2025);
+            }
+        }
+        ingestDone.store(true);
+    });
+
+    int passes = 0;
+    bool consistent = true;
+    while (!ingestDone.load()) {
+        int count = 0;
+        long long idSum = 0;
+        report.forEach([&](const StoredBook& book) {
+            count++;
+            idSum += book.id;
+        });
+        consistent = consistent && count == INITIAL_BOOKS && idSum == (long long)INITIAL_BOOKS * (INITIAL_BOOKS - 1);
+        passes++;
+    }
+    ingest.join();
+
+    CatalogSnapshot latest = catalog.snapshot();
+    cout << "Snapshot of " << report.size() << " books taken in " << fixed << setprecision(2) << snapshotMicros
+         << " us (a full copy takes " << copyMicros << " us)\n";
+    cout << "Report scanned its snapshot " << passes << " times during " << INGEST_WRITES << " writes: "
+         << (consistent ? "every pass saw the same " + to_string(report.size()) + " books" : "INCONSISTENT") << "\n";
+    cout << "Snapshot version " << report.version() << " vs latest version " << latest.version() << " with "
+         << latest.size() << " books\n";
+    cout << "===================================\n\n";
+}
+
+// Clear the input buffer
+void clearInputBuffer() {
+    cin.clear();
+    cin.ignore(numeric_limits<streamsize>::max(), '\n');
+}
+
+// Display menu
+void displayMenu() {
+    cout << "\n===== Book Catalog Menu =====\n";
+    cout << "1. Add new book\n";
+    cout << "2. Display all books (in-order)\n";
+    cout << "3. Display all books (pre-order)\n";
+    cout << "4. Search for a book\n";
+    cout << "5. Remove a book\n";
+    cout << "6. Find the k-th book by ID\n";
+    cout << "7. Count books below an ID\n";
+    cout << "8. Display a page of books\n";
+    cout << "9. Export catalog to CSV\n";
+    cout << "10. Run concurrent catalog benchmark\n";
+    cout << "11. Run snapshot isolation demo\n";
+    cout << "12. Open persistent catalog\n";
+    cout << "13. Exit\n";
+    cout << "Enter your choice (1-13): ";
+}
+
+// Display the persistent catalog menu
+void displayPersistentMenu() {
+    cout << "\n===== Persistent Catalog Menu =====\n";
+    cout << "1. Add new book\n";
+    cout << "2. Display all books\n";
+    cout << "3. Search for a book\n";
+    cout << "4. Remove a book\n";
+    cout << "5. Checkpoint now\n";
+    cout << "6. Run storage engine benchmark\n";
+    cout << "7. Back to main menu\n";
+    cout << "Enter your choice (1-7): ";
+}
+
+// Work with a catalog stored on disk; changes survive restarts
+void runPersistentCatalog() {
+    string directory;
+    cout << "Enter catalog directory (blank for bookcatalog_data): ";
+    getline(cin, directory);
+    if (directory.empty()) {
+        directory = "bookcatalog_data";
+    }
+
+    DiskBookCatalog catalog(directory);
+    if (!catalog.isOpen()) {
+        return;
+    }
+    cout << "Opened " << directory << ": " << catalog.size() << " books, recovered in " << fixed << setprecision(2)
+         << catalog.lastRecoveryMillis() << " ms from " << catalog.logSize() << " bytes of log.\n";
+    if (catalog.size() == 0) {
+        catalog.addBook(1003, "To Kill a Mockingbird", "Harper Lee", 1960);
+        catalog.addBook(1001, "1984", "George Orwell", 1949);
+        catalog.addBook(1005, "The Great Gatsby", "F. Scott Fitzgerald", 1925);
+        catalog.addBook(1002, "Pride and Prejudice", "Jane Austen", 1813);
+        catalog.addBook(1004, "The Catcher in the Rye", "J.D. Salinger", 1951);
+        cout << "New catalog seeded with 5 sample books.\n";
+    }
+
+    int choice, id, year;
+    string title, author;
+    StoredBook book;
+    while (true) {
+        displayPersistentMenu();
+
+        if (!(cin >> choice)) {
+            cout << "Invalid input. Please enter a number.\n";
+            clearInputBuffer();
+            continue;
+        }
+        clearInputBuffer();
+
+        switch (choice) {
+            case 1:
+                cout << "Enter book ID: ";
+                if (!(cin >> id)) {
+                    cout << "Invalid ID. Please enter a number.\n";
+                    clearInputBuffer();
+                    break;
+                }
+                clearInputBuffer();
+
+                cout << "Enter book title: ";
+                getline(cin, title);
+
+                cout << "Enter book author: ";
+                getline(cin, author);
+
+                cout << "Enter publication year: ";
+                if (!(cin >> year)) {
+                    cout << "Invalid year. Using current year.\n";
+                    clearInputBuffer();
+                    year = 2025;  // Current year
+                } else {
+                    clearInputBuffer();
+                }
+
+                if (catalog.addBook(id, title, author, year)) {
+                    cout << "Book added: " << title << " by " << author << " (ID: " << id << ")\n";
+                } else if (!catalog.isOpen()) {
+                    cout << "Error: Book with ID " << id << " was not saved!\n";
+                } else if (catalog.searchBook(id)) {
+                    cout << "Error: Book with ID " << id << " already exists!\n";
+                }
+                break;
+
+            case 2:
+                catalog.displayAllBooks();
+                break;
+
+            case 3:
+                cout << "Enter book ID to search: ";
+                if (!(cin >> id)) {
+                    cout << "Invalid ID. Please enter a number.\n";
+                    clearInputBuffer();
+                    break;
+                }
+                clearInputBuffer();
+
+                if (catalog.findBook(id, book)) {
+                    cout << "\n===== Book Details =====\n";
+                    cout << "ID: " << book.id << endl;
+                    cout << "Title: " << book.title << endl;
+                    cout << "Author: " << book.author << endl;
+                    cout << "Year: " << book.year << endl;
+                    cout << "========================\n\n";
+                } else {
+                    cout << "Book with ID " << id << " not found!\n";
+                }
+                break;
+
+            case 4:
+                cout << "Enter book ID to remove: ";
+                if (!(cin >> id)) {
+                    cout << "Invalid ID. Please enter a number.\n";
+                    clearInputBuffer();
+                    break;
+                }
+                clearInputBuffer();
+
+                if (catalog.deleteBook(id)) {
+                    cout << "Book with ID " << id << " has been removed from catalog.\n";
+                } else if (!catalog.isOpen()) {
+                    cout << "Error: Book with ID " << id << " was not removed!\n";
+                } else {
+                    cout << "Book with ID " << id << " not found!\n";
+                }
+                break;
+
+            case 5:
+                if (catalog.checkpoint()) {
+                    cout << "Checkpoint written; the log is empty again.\n";
+                }
+                break;
 
             case 6:
+                runStorageBenchmark();
+                break;
+
+            case 7:
+                return;
+
+            default:
+                cout << "Invalid choice. Please enter a number between 1 and 7.\n";
+        }
+    }
+}
+
+int main() {
+    BookCatalog catalog;
+    int choice, id, year;
+    string title, author;
+    bool running = true;
+
+    cout << "Welcome to the Book Catalog (Binary Search Tree Implementation)!\n";
+    cout << "Books are organized by their unique ID numbers.\n";
+
+    // Add some sample books
+    catalog.addBook(1003, "To Kill a Mockingbird", "Harper Lee", 1960);
+    catalog.addBook(1001, "1984", "George Orwell", 1949);
+    catalog.addBook(1005, "The Great Gatsby", "F. Scott Fitzgerald", 1925);
+    catalog.addBook(1002, "Pride and Prejudice", "Jane Austen", 1813);
+    catalog.addBook(1004, "The Catcher in the Rye", "J.D. Salinger", 1951);
+
+    while (running) {
+        displayMenu();
+
+        if (!(cin >> choice)) {
+            cout << "Invalid input. Please enter a number.\n";
+            clearInputBuffer();
+            continue;
+        }
+        clearInputBuffer();
+
+        switch (choice) {
+            case 1:
+                cout << "Enter book ID: ";
+                if (!(cin >> id)) {
+                    cout << "Invalid ID. Please enter a number.\n";
+                    clearInputBuffer();
+                    break;
+                }
+                clearInputBuffer();
+
+                cout << "Enter book title: ";
+                getline(cin, title);
+
+                cout << "Enter book author: ";
+                getline(cin, author);
+
+                cout << "Enter publication year: ";
+                if (!(cin >> year)) {
+                    cout << "Invalid year. Using current year.\n";
+                    clearInputBuffer();
+                    year = 2025;  // Current year
+                } else {
+                    clearInputBuffer();
+                }
+
+                catalog.addBook(id, title, author, year);
+                break;
+
+            case 2:
+                catalog.displayAllBooks();
+                break;
+
+            case 3:
+                catalog.displayAllBooksPreOrder();
+                break;
+
+            case 4:
+                cout << "Enter book ID to search: ";
+                if (!(cin >> id)) {
+                    cout << "Invalid ID. Please enter a number.\n";
+                    clearInputBuffer();
+                    break;
+                }
+                clearInputBuffer();
+
+                if (catalog.searchBook(id)) {
+                    catalog.displayBook(id);
+                } else {
+                    cout << "Book with ID " << id << " not found!\n";
+                }
+                break;
+
+            case 5:
+                cout << "Enter book ID to remove: ";
+                if (!(cin >> id)) {
+                    cout << "Invalid ID. Please enter a number.\n";
+                    clearInputBuffer();
+                    break;
+                }
+                clearInputBuffer();
+
+                catalog.deleteBook(id);
+                break;
+
+            case 6: {
+                int k;
+                cout << "Enter position (1 = smallest ID): ";
+                if (!(cin >> k)) {
+                    cout << "Invalid position. Please enter a number.\n";
+                    clearInputBuffer();
+                    break;
+                }
+                clearInputBuffer();
+
+                const Book* book = catalog.select(k - 1);
+                if (book == nullptr) {
+                    cout << "Position " << k << " is out of range (catalog has " << catalog.size() << " books).\n";
+                } else {
+                    catalog.displayBook(book->id);
+                }
+                break;
+            }
+
+            case 7:
+                cout << "Enter book ID: ";
+                if (!(cin >> id)) {
+                    cout << "Invalid ID. Please enter a number.\n";
+                    clearInputBuffer();
+                    break;
+                }
+                clearInputBuffer();
+
+                cout << catalog.rank(id) << " of " << catalog.size() << " books have an ID below " << id << ".\n";
+                break;
+
+            case 8: {
+                int start, count;
+                cout << "Enter starting position and page size: ";
+                if (!(cin >> start >> count) || count <= 0) {
+                    cout << "Invalid input. Please enter two positive numbers.\n";
+                    clearInputBuffer();
+                    break;
+                }
+                clearInputBuffer();
+
+                catalog.displayPage(start - 1, count);
+                break;
+            }
+
+            case 9: {
+                string path;
+                cout << "Enter file name (blank for catalog.csv): ";
+                getline(cin, path);
+                if (path.empty()) {
+                    path = "catalog.csv";
+                }
+
+                ofstream file(path);
+                if (!file) {
+                    cout << "Error: cannot open " << path << " for writing!\n";
+                    break;
+                }
+                catalog.exportCSV(file);
+                cout << "Exported " << catalog.size() << " books to " << path << ".\n";
+                break;
+            }
+
+            case 10:
+                runConcurrentBenchmark();
+                break;
+
+            case 11:
+                runSnapshotDemo();
+                break;
+
+            case 12:
+                runPersistentCatalog();
+                break;
+
+            case 13:
                 cout << "Exiting Book Catalog. Goodbye!\n";
                 running = false;
                 break;
 
             default:
-                cout << "Invalid choice. Please enter a number between 1 and 6.\n";
+                cout << "Invalid choice. Please enter a number between 1 and 13.\n";
         }
     }
 